@@ -0,0 +1,97 @@
+// Trace-driven comparison of eviction policies: LRU versus W-TinyLFU.
+//
+// Each trace is replayed read-through (try_get, put on a miss) against
+// LRUCache with LruPolicy and with TinyLfuPolicy, reporting hit ratio and
+// million accesses per second. Built-in traces over `keys` keys:
+//
+//   zipf        Zipf s=0.9
+//   zipf+scan   the same, with a sequential scan of `keys` never-repeated
+//               keys after every `ops`/10 accesses (a batch job)
+//   loop        cycling through 1.25x the cache size (LRU's worst case)
+//
+// trace=<file> replays a file of whitespace-separated integer keys instead.
+//
+// Usage: bench_cache_policy [ops=2000000] [keys=100000] [capacity=5000] [trace=file]
+#include "LRUCache.h"
+#include "bench_util.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Trace {
+    std::string name;
+    std::vector<int> keys;
+};
+
+std::vector<int> zipf_keys(size_t ops, size_t keys, unsigned seed) {
+    bench::Zipf zipf(keys, 0.9);
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<int> trace(ops);
+    for (auto& k : trace) k = static_cast<int>(zipf(u(rng)));
+    return trace;
+}
+
+template<class Cache>
+void replay(const char* policy, size_t capacity, const std::vector<int>& trace) {
+    Cache cache(capacity);
+    size_t hits = 0;
+    auto start = bench::Clock::now();
+    for (int k : trace) {
+        if (cache.try_get(k)) ++hits;
+        else cache.put(k, k);
+    }
+    double secs = bench::seconds_since(start);
+    std::printf("  %-9s hit ratio %6.2f%%  %7.2f Mops/s\n", policy, 100.0 * hits / trace.size(),
+                trace.size() / secs / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 2000000));
+    const size_t keys = static_cast<size_t>(bench::arg_or(argc, argv, "keys", 100000));
+    const size_t capacity = static_cast<size_t>(bench::arg_or(argc, argv, "capacity", 5000));
+    const std::string file = bench::arg_str(argc, argv, "trace", "");
+
+    std::vector<Trace> traces;
+    if (!file.empty()) {
+        std::ifstream in(file);
+        Trace t{file, {}};
+        for (long long k; in >> k;) t.keys.push_back(static_cast<int>(k));
+        if (t.keys.empty()) {
+            std::fprintf(stderr, "no keys read from %s\n", file.c_str());
+            return 1;
+        }
+        traces.push_back(std::move(t));
+    } else {
+        traces.push_back({"zipf", zipf_keys(ops, keys, 1)});
+
+        Trace scan{"zipf+scan", {}};
+        const std::vector<int> base = zipf_keys(ops, keys, 2);
+        int cold = static_cast<int>(keys);
+        for (size_t i = 0; i < base.size(); ++i) {
+            scan.keys.push_back(base[i]);
+            if ((i + 1) % (ops / 10 + 1) == 0)
+                for (size_t j = 0; j < keys; ++j) scan.keys.push_back(cold++);
+        }
+        traces.push_back(std::move(scan));
+
+        Trace loop{"loop", std::vector<int>(ops)};
+        const size_t period = capacity + capacity / 4;
+        for (size_t i = 0; i < ops; ++i) loop.keys[i] = static_cast<int>(i % period);
+        traces.push_back(std::move(loop));
+    }
+
+    for (const Trace& t : traces) {
+        std::printf("%s: %zu accesses, capacity %zu\n", t.name.c_str(), t.keys.size(), capacity);
+        replay<IntLRUCache>("LRU", capacity, t.keys);
+        replay<TinyLfuCache<int, int>>("W-TinyLFU", capacity, t.keys);
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Miss-storm latency: many threads asking for a hot key the moment it drops
+// out of the cache.
+//
+// The backend takes `backend_us` per call and serves at most `slots` calls
+// at a time, like a connection pool. Each storm invalidates the hot key and
+// releases `threads` clients on it together. With the get-then-put pattern
+// every client misses and calls the backend itself, so the calls queue for
+// the slots and the last client waits about threads / slots backend calls.
+// LoadingCache coalesces the storm into one call that every client waits on.
+// Reports backend calls per storm and client latency percentiles.
+//
+// Usage: bench_loading_cache [threads=64] [storms=50] [backend_us=2000] [slots=4]
+#include "LoadingCache.h"
+#include "bench_util.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Sleeps `latency` per call with at most `slots` calls in progress.
+class Backend {
+public:
+    Backend(std::chrono::microseconds latency, int slots) : latency(latency), free_slots(slots) {}
+
+    int fetch(int key) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            freed.wait(lock, [this] { return free_slots > 0; });
+            --free_slots;
+            ++calls;
+        }
+        std::this_thread::sleep_for(latency);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++free_slots;
+        }
+        freed.notify_one();
+        return key * 2;
+    }
+
+    long long take_calls() {
+        std::lock_guard<std::mutex> lock(mutex);
+        long long n = calls;
+        calls = 0;
+        return n;
+    }
+
+private:
+    std::chrono::microseconds latency;
+    std::mutex mutex;
+    std::condition_variable freed;
+    int free_slots;
+    long long calls = 0;
+};
+
+// Runs `clients` threads through `storms` rounds: before each, `reset` drops
+// the hot key; then all clients call `lookup` at once.
+void storm(const char* name, int clients, int storms, Backend& backend, const std::function<void()>& reset,
+           const std::function<int()>& lookup) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    int round = 0, arrived = 0;
+    std::vector<std::vector<long long>> latencies(clients);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c] {
+            for (int r = 1; r <= storms; ++r) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return round >= r; });
+                }
+                auto t0 = bench::Clock::now();
+                bench::do_not_optimize(lookup());
+                latencies[c].push_back(bench::nanos_since(t0));
+                std::lock_guard<std::mutex> lock(mutex);
+                if (++arrived == clients) cv.notify_all();
+            }
+        });
+    }
+    backend.take_calls();
+    for (int r = 1; r <= storms; ++r) {
+        reset();
+        std::unique_lock<std::mutex> lock(mutex);
+        arrived = 0;
+        round = r;
+        cv.notify_all();
+        cv.wait(lock, [&] { return arrived == clients; });
+    }
+    for (auto& t : threads) t.join();
+
+    std::vector<long long> all;
+    for (auto& v : latencies) all.insert(all.end(), v.begin(), v.end());
+    std::printf("%-22s %12.1f %10.0f %10.0f %10.0f\n", name, static_cast<double>(backend.take_calls()) / storms,
+                bench::percentile(all, 50) / 1e3, bench::percentile(all, 99) / 1e3,
+                bench::percentile(all, 100) / 1e3);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int clients = static_cast<int>(bench::arg_or(argc, argv, "threads", 64));
+    const int storms = static_cast<int>(bench::arg_or(argc, argv, "storms", 50));
+    const auto latency = std::chrono::microseconds(bench::arg_or(argc, argv, "backend_us", 2000));
+    const int slots = static_cast<int>(bench::arg_or(argc, argv, "slots", 4));
+    const int hot = 42;
+
+    Backend backend(latency, slots);
+    std::printf("%d clients, %d storms, backend %lld us x %d slots\n", clients, storms,
+                static_cast<long long>(latency.count()), slots);
+    std::printf("%-22s %12s %10s %10s %10s\n", "", "calls/storm", "p50 us", "p99 us", "max us");
+
+    {
+        IntLRUCache cache(1024);
+        std::mutex mutex;
+        storm(
+            "get + put on miss", clients, storms, backend,
+            [&] {
+                std::lock_guard<std::mutex> lock(mutex);
+                cache.erase(hot);
+            },
+            [&] {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (int* v = cache.try_get(hot)) return *v;
+                }
+                int v = backend.fetch(hot);
+                std::lock_guard<std::mutex> lock(mutex);
+                cache.put(hot, v);
+                return v;
+            });
+    }
+    {
+        SimpleThreadPool pool(4);
+        LoadingCache<int, int> cache(pool, 1024, [&](const int& key) { return backend.fetch(key); });
+        storm(
+            "LoadingCache", clients, storms, backend, [&] { cache.invalidate(hot); },
+            [&] { return cache.get(hot); });
+    }
+    return 0;
+}
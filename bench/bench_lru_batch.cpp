@@ -0,0 +1,99 @@
+// Batched lookups and writes versus one call per key on a cache far larger
+// than the last-level cache.
+//
+// Every single get() on such a cache waits for at least two dependent misses
+// (bucket, then node). get_many()/put_many() hash a group of keys and
+// prefetch all their buckets, then all their nodes, before resolving any,
+// so the misses of a group overlap. Keys are uniform over the capacity for
+// gets (all hits) and over twice the capacity for puts (half evict). The
+// table shows ns per key for single calls and for batches of `batch` keys,
+// the size a request handler would pass. Each cache runs in its own forked
+// child so it starts from a fresh heap.
+//
+// Usage: bench_lru_batch [capacity=8000000] [ops=4000000] [batch=100]
+#include "FlatLRUCache.h"
+#include "LRUCache.h"
+#include "bench_util.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+template<class Cache>
+void measure(const char* name, size_t capacity, size_t batch, const std::vector<int>& gets,
+             const std::vector<int>& puts) {
+    Cache cache(capacity);
+    // Insert in random order so neighbouring keys do not share cache lines.
+    std::vector<int> fill(capacity);
+    for (size_t k = 0; k < capacity; ++k) fill[k] = static_cast<int>(k);
+    std::shuffle(fill.begin(), fill.end(), std::mt19937_64(2));
+    for (int k : fill) cache.put(k, k);
+
+    const size_t n = gets.size();
+    std::vector<int> out(batch);
+    long long sink = 0;
+
+    auto start = bench::Clock::now();
+    for (int k : gets) sink += cache.get(k);
+    const double get_single = bench::nanos_since(start) / static_cast<double>(n);
+
+    start = bench::Clock::now();
+    for (size_t i = 0; i < n; i += batch) {
+        const size_t m = std::min(batch, n - i);
+        sink += static_cast<long long>(cache.get_many(gets.data() + i, m, out.data()));
+    }
+    const double get_batch = bench::nanos_since(start) / static_cast<double>(n);
+
+    start = bench::Clock::now();
+    for (int k : puts) cache.put(k, k);
+    const double put_single = bench::nanos_since(start) / static_cast<double>(n);
+
+    start = bench::Clock::now();
+    for (size_t i = 0; i < n; i += batch) {
+        const size_t m = std::min(batch, n - i);
+        cache.put_many(puts.data() + i, puts.data() + i, m);
+    }
+    const double put_batch = bench::nanos_since(start) / static_cast<double>(n);
+
+    bench::do_not_optimize(sink);
+    std::printf("%-24s %10.1f %10.1f %10.1f %10.1f\n", name, get_single, get_batch, put_single, put_batch);
+}
+
+template<class Cache>
+void run(const char* name, size_t capacity, size_t batch, const std::vector<int>& gets,
+         const std::vector<int>& puts) {
+    std::fflush(stdout);
+    pid_t child = fork();
+    if (child == 0) {
+        measure<Cache>(name, capacity, batch, gets, puts);
+        std::fflush(stdout);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t capacity = static_cast<size_t>(bench::arg_or(argc, argv, "capacity", 8000000));
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 4000000));
+    const size_t batch = static_cast<size_t>(std::max(1LL, bench::arg_or(argc, argv, "batch", 100)));
+
+    std::mt19937_64 rng(1);
+    std::vector<int> gets(ops), puts(ops);
+    for (auto& k : gets) k = static_cast<int>(rng() % capacity);
+    for (auto& k : puts) k = static_cast<int>(rng() % (2 * capacity));
+
+    std::printf("capacity %zu, %zu ops, batch %zu (ns/key)\n", capacity, ops, batch);
+    std::printf("%-24s %10s %10s %10s %10s\n", "cache", "get", "get_many", "put", "put_many");
+    run<LRUCache<int, int>>("LRUCache<int, int>", capacity, batch, gets, puts);
+    run<FlatLRUCache<int, int>>("FlatLRUCache<int, int>", capacity, batch, gets, puts);
+    return 0;
+}
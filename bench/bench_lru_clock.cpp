@@ -0,0 +1,127 @@
+// Exact LRU versus CLOCK on Zipfian read-through workloads.
+//
+// Part one replays one Zipfian key trace (skew 0.8 and 0.99 over `keys` keys)
+// single-threaded through LRUCache and ClockCache at several cache sizes:
+// get, and put on a miss. It reports hit ratio and ns per access, i.e. what
+// CLOCK's approximate recency costs in hits and saves in bookkeeping.
+//
+// Part two runs the same read-through loop from 1, 2, 4, ... `max_threads`
+// threads (skew 0.99, cache at 10% of the keys) against LRUCache behind one
+// mutex, ShardedLRUCache and ClockCache, whose gets take no lock.
+//
+// Usage: bench_lru_clock [ops=2000000] [keys=1000000] [max_threads=32]
+#include "ClockCache.h"
+#include "LRUCache.h"
+#include "ShardedLRUCache.h"
+#include "bench_util.h"
+
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class LockedLRUCache {
+public:
+    explicit LockedLRUCache(size_t capacity) : cache(capacity) {}
+
+    int get(int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cache.get(key);
+    }
+
+    void put(int key, int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.put(key, value);
+    }
+
+private:
+    std::mutex mutex;
+    IntLRUCache cache;
+};
+
+std::vector<int> zipf_trace(size_t ops, size_t keys, double skew, unsigned seed) {
+    bench::Zipf zipf(keys, skew);
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    // Scatter ranks over the key space so hot keys are not also adjacent ints;
+    // the same permutation for every trace, so threads share their hot set.
+    std::vector<int> perm(keys);
+    for (size_t i = 0; i < keys; ++i) perm[i] = static_cast<int>(i);
+    std::shuffle(perm.begin(), perm.end(), std::mt19937(1));
+    std::vector<int> trace(ops);
+    for (auto& k : trace) k = perm[zipf(u(rng))];
+    return trace;
+}
+
+// Returns the number of hits.
+template<class Cache>
+size_t replay(Cache& cache, const std::vector<int>& trace) {
+    size_t hits = 0;
+    for (int k : trace) {
+        if (cache.get(k) != -1) ++hits;
+        else cache.put(k, k);
+    }
+    return hits;
+}
+
+template<class Cache>
+void hit_ratio_row(const char* name, size_t capacity, const std::vector<int>& trace) {
+    Cache cache(capacity);
+    auto start = bench::Clock::now();
+    size_t hits = replay(cache, trace);
+    double ns = bench::nanos_since(start) / static_cast<double>(trace.size());
+    std::printf("  %-6s capacity %8zu  hit ratio %6.2f%%  %6.1f ns/op\n", name, capacity,
+                100.0 * hits / trace.size(), ns);
+}
+
+// Million accesses per second across all threads.
+template<class Cache>
+double throughput(Cache& cache, const std::vector<std::vector<int>>& traces) {
+    std::vector<std::thread> workers;
+    auto start = bench::Clock::now();
+    size_t total = 0;
+    for (const auto& trace : traces) {
+        total += trace.size();
+        workers.emplace_back([&cache, &trace] { bench::do_not_optimize(replay(cache, trace)); });
+    }
+    for (auto& w : workers) w.join();
+    return total / bench::seconds_since(start) / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 2000000));
+    const size_t keys = static_cast<size_t>(bench::arg_or(argc, argv, "keys", 1000000));
+    const size_t max_threads = static_cast<size_t>(bench::arg_or(argc, argv, "max_threads", 32));
+
+    for (double skew : {0.8, 0.99}) {
+        std::vector<int> trace = zipf_trace(ops, keys, skew, 1);
+        std::printf("Zipf s=%.2f, %zu keys, %zu accesses\n", skew, keys, ops);
+        for (size_t capacity : {keys / 1000, keys / 100, keys / 10}) {
+            if (capacity == 0) continue;
+            hit_ratio_row<IntLRUCache>("LRU", capacity, trace);
+            hit_ratio_row<ClockCache>("CLOCK", capacity, trace);
+        }
+    }
+
+    const size_t capacity = std::max<size_t>(1, keys / 10);
+    std::printf("\nread-through throughput, Zipf s=0.99, capacity %zu\n", capacity);
+    std::printf("%8s %14s %14s %14s\n", "threads", "mutex Mops/s", "sharded Mops/s", "CLOCK Mops/s");
+    for (size_t threads : bench::thread_counts(max_threads)) {
+        std::vector<std::vector<int>> traces;
+        for (size_t t = 0; t < threads; ++t)
+            traces.push_back(zipf_trace(ops / threads, keys, 0.99, static_cast<unsigned>(t + 1)));
+        LockedLRUCache locked(capacity);
+        ShardedLRUCache sharded(capacity, 64);
+        ClockCache clock(capacity);
+        double a = throughput(locked, traces);
+        double b = throughput(sharded, traces);
+        double c = throughput(clock, traces);
+        std::printf("%8zu %14.2f %14.2f %14.2f\n", threads, a, b, c);
+    }
+    return 0;
+}
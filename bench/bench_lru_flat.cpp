@@ -0,0 +1,141 @@
+// Memory per entry and ns/op for three LRU layouts, int keys and values:
+//
+//   list+map   the original LRUCache: std::list<int> plus std::unordered_map
+//   node       LRUCache<int, int>: one node per entry on list and bucket chain
+//   flat       FlatLRUCache<int, int>: preallocated slab, 32-bit links,
+//              open-addressing index
+//
+// Memory is the heap held once the cache is full, measured as usable bytes
+// of every live allocation. Timings: random get hits on a full cache, and
+// puts of new keys (every one evicts), with allocations per put. Each layout
+// runs in its own forked child so it starts from a fresh heap.
+//
+// Usage: bench_lru_flat [capacity=1000000] [ops=5000000]
+#include "FlatLRUCache.h"
+#include "LRUCache.h"
+#include "bench_util.h"
+
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <new>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+std::atomic<long long> live_bytes{0};
+std::atomic<size_t> allocations{0};
+}
+
+void* operator new(size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    live_bytes.fetch_add(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    live_bytes.fetch_sub(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+    std::free(p);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+namespace {
+
+// The layout LRUCache had before it became a template.
+class ListMapLRUCache {
+public:
+    explicit ListMapLRUCache(size_t cap) : capacity(cap) {}
+
+    int get(int key) {
+        auto it = cache.find(key);
+        if (it == cache.end()) return -1;
+        lru_list.erase(it->second.second);
+        lru_list.push_front(key);
+        it->second.second = lru_list.begin();
+        return it->second.first;
+    }
+
+    void put(int key, int value) {
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            lru_list.erase(it->second.second);
+            lru_list.push_front(key);
+            cache[key] = {value, lru_list.begin()};
+            return;
+        }
+        if (cache.size() >= capacity) {
+            int lru_key = lru_list.back();
+            lru_list.pop_back();
+            cache.erase(lru_key);
+        }
+        lru_list.push_front(key);
+        cache[key] = {value, lru_list.begin()};
+    }
+
+private:
+    size_t capacity;
+    std::list<int> lru_list;
+    std::unordered_map<int, std::pair<int, std::list<int>::iterator>> cache;
+};
+
+template<class Cache>
+void measure(const char* name, size_t capacity, const std::vector<int>& hits, const std::vector<int>& misses) {
+    long long before = live_bytes.load();
+    Cache cache(capacity);
+    for (size_t k = 0; k < capacity; ++k) cache.put(static_cast<int>(k), static_cast<int>(k));
+    double bytes = static_cast<double>(live_bytes.load() - before) / capacity;
+
+    long long sink = 0;
+    auto start = bench::Clock::now();
+    for (int k : hits) sink += cache.get(k);
+    double get_ns = bench::nanos_since(start) / static_cast<double>(hits.size());
+    bench::do_not_optimize(sink);
+
+    size_t allocs = allocations.load();
+    start = bench::Clock::now();
+    for (int k : misses) cache.put(k, k);
+    double put_ns = bench::nanos_since(start) / static_cast<double>(misses.size());
+    double put_allocs = static_cast<double>(allocations.load() - allocs) / misses.size();
+
+    std::printf("%-9s %10.1f %10.1f %10.1f %12.2f\n", name, bytes, get_ns, put_ns, put_allocs);
+}
+
+template<class Cache>
+void run(const char* name, size_t capacity, const std::vector<int>& hits, const std::vector<int>& misses) {
+    std::fflush(stdout);
+    pid_t child = fork();
+    if (child == 0) {
+        measure<Cache>(name, capacity, hits, misses);
+        std::fflush(stdout);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t capacity = static_cast<size_t>(bench::arg_or(argc, argv, "capacity", 1000000));
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 5000000));
+
+    std::mt19937_64 rng(1);
+    std::vector<int> hits(ops), misses(ops);
+    for (auto& k : hits) k = static_cast<int>(rng() % capacity);
+    for (size_t i = 0; i < ops; ++i) misses[i] = static_cast<int>(capacity + i);
+
+    std::printf("capacity %zu, %zu ops\n", capacity, ops);
+    std::printf("%-9s %10s %10s %10s %12s\n", "layout", "B/entry", "get ns", "put ns", "allocs/put");
+    run<ListMapLRUCache>("list+map", capacity, hits, misses);
+    run<LRUCache<int, int>>("node", capacity, hits, misses);
+    run<FlatLRUCache<int, int>>("flat", capacity, hits, misses);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Read-through lookups: get followed by put on a miss versus get_or_compute.
+//
+// The old pattern probes twice on every miss (get returns the -1 sentinel,
+// then put looks the key up again before inserting); get_or_compute finds
+// either the entry or its insertion point in one probe. Keys are uniform over
+// `spread` times the capacity, so roughly 1 - 1/spread of lookups miss. The
+// "loader" is a cheap function of the key so the cache dominates. Runs on
+// LRUCache and FlatLRUCache.
+//
+// Usage: bench_lru_lookup [capacity=1000000] [ops=5000000] [spread=4]
+#include "FlatLRUCache.h"
+#include "LRUCache.h"
+#include "bench_util.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+int load(int key) { return key * 7 + 1; }
+
+template<class Cache, class Lookup>
+void measure(const char* name, size_t capacity, const std::vector<int>& trace, Lookup lookup) {
+    Cache cache(capacity);
+    for (size_t k = 0; k < capacity; ++k) cache.put(static_cast<int>(k), load(static_cast<int>(k)));
+    long long sink = 0;
+    auto start = bench::Clock::now();
+    for (int k : trace) sink += lookup(cache, k);
+    double ns = bench::nanos_since(start) / static_cast<double>(trace.size());
+    bench::do_not_optimize(sink);
+    std::printf("  %-26s %7.1f ns/op\n", name, ns);
+}
+
+template<class Cache>
+void run(const char* title, size_t capacity, const std::vector<int>& trace) {
+    std::printf("%s\n", title);
+    measure<Cache>("get + put on miss", capacity, trace, [](Cache& c, int k) {
+        int v = c.get(k);
+        if (v == -1) {
+            v = load(k);
+            c.put(k, v);
+        }
+        return v;
+    });
+    measure<Cache>("try_get + put on miss", capacity, trace, [](Cache& c, int k) {
+        if (int* v = c.try_get(k)) return *v;
+        int v = load(k);
+        c.put(k, v);
+        return v;
+    });
+    measure<Cache>("get_or_compute", capacity, trace,
+                   [](Cache& c, int k) { return c.get_or_compute(k, [k] { return load(k); }); });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t capacity = static_cast<size_t>(bench::arg_or(argc, argv, "capacity", 1000000));
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 5000000));
+    const size_t spread = static_cast<size_t>(bench::arg_or(argc, argv, "spread", 4));
+
+    std::mt19937_64 rng(1);
+    std::vector<int> trace(ops);
+    for (auto& k : trace) k = static_cast<int>(rng() % (capacity * spread));
+
+    std::printf("capacity %zu, keys %zu, %zu ops\n", capacity, capacity * spread, ops);
+    run<LRUCache<int, int>>("LRUCache<int, int>", capacity, trace);
+    run<FlatLRUCache<int, int>>("FlatLRUCache<int, int>", capacity, trace);
+    return 0;
+}
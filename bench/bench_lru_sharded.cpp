@@ -0,0 +1,85 @@
+// Concurrent get/put throughput: one LRUCache behind a single mutex versus
+// ShardedLRUCache.
+//
+// Every thread runs the same mix (`put_pct` percent puts, the rest gets) over
+// keys drawn uniformly from `keys`, against a cache holding half of them, so
+// roughly half the gets miss and the puts keep evicting. Thread counts run
+// 1, 2, 4, ... up to `max_threads`.
+//
+// Usage: bench_lru_sharded [ops=1000000] [keys=200000] [put_pct=10] [shards=64] [max_threads=32]
+#include "LRUCache.h"
+#include "ShardedLRUCache.h"
+#include "bench_util.h"
+
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class LockedLRUCache {
+public:
+    explicit LockedLRUCache(size_t capacity) : cache(capacity) {}
+
+    int get(int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cache.get(key);
+    }
+
+    void put(int key, int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.put(key, value);
+    }
+
+private:
+    std::mutex mutex;
+    IntLRUCache cache;
+};
+
+// Million operations per second across all threads.
+template<class Cache>
+double run(Cache& cache, size_t threads, size_t ops, int keys, int put_pct) {
+    std::vector<std::thread> workers;
+    auto start = bench::Clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&cache, t, ops, keys, put_pct] {
+            std::mt19937 rng(static_cast<unsigned>(t + 1));
+            std::uniform_int_distribution<int> key(0, keys - 1);
+            std::uniform_int_distribution<int> pct(0, 99);
+            long long sink = 0;
+            for (size_t i = 0; i < ops; ++i) {
+                int k = key(rng);
+                if (pct(rng) < put_pct) cache.put(k, k);
+                else sink += cache.get(k);
+            }
+            bench::do_not_optimize(sink);
+        });
+    }
+    for (auto& w : workers) w.join();
+    return threads * ops / bench::seconds_since(start) / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 1000000));
+    const int keys = static_cast<int>(bench::arg_or(argc, argv, "keys", 200000));
+    const int put_pct = static_cast<int>(bench::arg_or(argc, argv, "put_pct", 10));
+    const size_t shards = static_cast<size_t>(bench::arg_or(argc, argv, "shards", 64));
+    const size_t max_threads = static_cast<size_t>(bench::arg_or(argc, argv, "max_threads", 32));
+    const size_t capacity = static_cast<size_t>(keys) / 2;
+
+    std::printf("%zu ops/thread, %d keys, capacity %zu, %d%% puts, %zu shards\n",
+                ops, keys, capacity, put_pct, shards);
+    std::printf("%8s %14s %14s %8s\n", "threads", "mutex Mops/s", "sharded Mops/s", "speedup");
+    for (size_t threads : bench::thread_counts(max_threads)) {
+        LockedLRUCache locked(capacity);
+        ShardedLRUCache sharded(capacity, shards);
+        double a = run(locked, threads, ops, keys, put_pct);
+        double b = run(sharded, threads, ops, keys, put_pct);
+        std::printf("%8zu %14.2f %14.2f %7.2fx\n", threads, a, b, b / a);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// String-keyed lookups with and without heterogeneous lookup.
+//
+// Keys arrive as std::string_view (as when parsed out of a request buffer)
+// and are `len` characters long, past the small-string buffer. The plain
+// LRUCache<std::string, int> has to build a std::string for every get and
+// put; StringLRUCache<int> hashes and compares the view directly. Reports
+// ns/op and heap allocations per op for a hit-heavy get loop and for
+// overwriting existing keys.
+//
+// Usage: bench_lru_string_keys [keys=100000] [ops=2000000] [len=40]
+#include "LRUCache.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+std::atomic<size_t> allocations{0};
+}
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+template<class Cache, class Op>
+void measure(const char* name, Cache& cache, const std::vector<std::string_view>& trace, Op op) {
+    size_t before = allocations.load();
+    auto start = bench::Clock::now();
+    long long sink = 0;
+    for (std::string_view key : trace) sink += op(cache, key);
+    double ns = bench::nanos_since(start) / static_cast<double>(trace.size());
+    double allocs = static_cast<double>(allocations.load() - before) / trace.size();
+    bench::do_not_optimize(sink);
+    std::printf("  %-28s %7.1f ns/op  %5.2f allocs/op\n", name, ns, allocs);
+}
+
+template<class Cache, class MakeKey>
+void run(const char* title, const std::vector<std::string>& keys, const std::vector<std::string_view>& trace,
+         MakeKey make_key) {
+    Cache cache(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) cache.put(keys[i], static_cast<int>(i));
+    std::printf("%s\n", title);
+    measure("get", cache, trace, [&](Cache& c, std::string_view k) { return c.get(make_key(k)); });
+    measure("put (existing key)", cache, trace, [&](Cache& c, std::string_view k) {
+        c.put(make_key(k), 1);
+        return 0;
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t key_count = static_cast<size_t>(bench::arg_or(argc, argv, "keys", 100000));
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 2000000));
+    const size_t len = static_cast<size_t>(bench::arg_or(argc, argv, "len", 40));
+
+    std::mt19937_64 rng(1);
+    std::vector<std::string> keys(key_count);
+    for (auto& k : keys) {
+        k.resize(len);
+        for (auto& ch : k) ch = static_cast<char>('a' + rng() % 26);
+    }
+    std::vector<std::string_view> trace(ops);
+    for (auto& v : trace) v = keys[rng() % key_count];
+
+    std::printf("%zu keys of %zu chars, %zu ops\n", key_count, len, ops);
+    run<LRUCache<std::string, int>>("LRUCache<std::string, int> (key built per op)", keys, trace,
+                                    [](std::string_view k) { return std::string(k); });
+    run<StringLRUCache<int>>("StringLRUCache<int> (string_view lookup)", keys, trace,
+                             [](std::string_view k) { return k; });
+    return 0;
+}
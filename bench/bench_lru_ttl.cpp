@@ -0,0 +1,90 @@
+// Cost of TTL support on LRUCache get and put.
+//
+// Compares the plain cache with ExpiringLRUCache reading CoarseClock (one
+// relaxed load per check) and, for reference, with a clock that calls
+// std::chrono::steady_clock::now() on every check. The TTL is long enough
+// that nothing expires, so the table shows pure bookkeeping overhead: the
+// deadline stored per node, the clock read per lookup and the incremental
+// sweep per write. With no TTL set only the first applies, since neither the
+// lookups nor the sweep read the clock while no entry has a deadline. `get` hits uniformly random cached keys; `put` writes
+// keys uniform over twice the capacity, so half are inserts that evict.
+// Each variant runs in its own forked child so it starts from a fresh heap.
+//
+// Usage: bench_lru_ttl [capacity=1000000] [ops=5000000]
+#include "LRUCache.h"
+#include "bench_util.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct SteadyClock {
+    int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+};
+
+template<class Cache>
+void measure(const char* name, Cache& cache, const std::vector<int>& gets, const std::vector<int>& puts) {
+    for (size_t k = 0; k < cache.capacity(); ++k) cache.put(static_cast<int>(k), static_cast<int>(k));
+    long long sink = 0;
+    auto start = bench::Clock::now();
+    for (int k : gets) sink += cache.get(k);
+    const double get_ns = bench::nanos_since(start) / static_cast<double>(gets.size());
+    start = bench::Clock::now();
+    for (int k : puts) cache.put(k, k);
+    const double put_ns = bench::nanos_since(start) / static_cast<double>(puts.size());
+    bench::do_not_optimize(sink);
+    std::printf("  %-40s %9.1f %9.1f\n", name, get_ns, put_ns);
+}
+
+// Builds a Cache of `capacity` in a child process, applies `setup` and
+// measures it.
+template<class Cache, class Setup>
+void run(const char* name, size_t capacity, const std::vector<int>& gets, const std::vector<int>& puts,
+         Setup setup) {
+    std::fflush(stdout);
+    pid_t child = fork();
+    if (child == 0) {
+        Cache cache(capacity);
+        setup(cache);
+        measure(name, cache, gets, puts);
+        std::fflush(stdout);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+}
+
+template<class Clock>
+using TtlCache = ExpiringLRUCache<int, int, Clock>;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace std::chrono_literals;
+    const size_t capacity = static_cast<size_t>(bench::arg_or(argc, argv, "capacity", 1000000));
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 5000000));
+
+    std::mt19937_64 rng(1);
+    std::vector<int> gets(ops), puts(ops);
+    for (auto& k : gets) k = static_cast<int>(rng() % capacity);
+    for (auto& k : puts) k = static_cast<int>(rng() % (2 * capacity));
+
+    std::printf("capacity %zu, %zu ops per column\n  %-40s %9s %9s\n", capacity, ops, "", "get ns", "put ns");
+    auto none = [](auto&) {};
+    auto hour = [](auto& cache) { cache.set_default_ttl(1h); };
+    run<IntLRUCache>("LRUCache<int, int> (no TTL)", capacity, gets, puts, none);
+    run<TtlCache<CoarseClock>>("ExpiringLRUCache, CoarseClock, no TTL set", capacity, gets, puts, none);
+    run<TtlCache<CoarseClock>>("ExpiringLRUCache, CoarseClock, 1h TTL", capacity, gets, puts, hour);
+    run<TtlCache<SteadyClock>>("ExpiringLRUCache, steady_clock, 1h TTL", capacity, gets, puts, hour);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Memory held by an entry-count cache versus a byte-budgeted one when value
+// sizes are heavy-tailed.
+//
+// Value sizes follow a Pareto distribution (shape `alpha_x100`/100, minimum
+// 64 bytes, capped at 512 KB), so most values are small and a few are huge.
+// Both caches are given the same `budget_mb`: the entry-count cache as
+// budget / typical (median) value size entries, the way a count limit gets
+// picked in practice, and the weighted cache as a byte budget with the value
+// length as weigher. Keys are Zipf-distributed, read-through. The
+// table shows, at intervals, the value bytes each cache holds and the heap
+// bytes live in the process (the other cache excluded), plus ns/op.
+//
+// Usage: bench_lru_weighted [ops=2000000] [keys=200000] [budget_mb=16] [alpha_x100=120]
+#include "LRUCache.h"
+#include "bench_util.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+std::atomic<long long> live_bytes{0};
+}
+
+void* operator new(size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    live_bytes.fetch_add(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+    return p;
+}
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    live_bytes.fetch_sub(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+    std::free(p);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+namespace {
+
+struct LengthWeigher {
+    size_t operator()(int, const std::string& v) const { return v.size(); }
+};
+
+template<class Cache>
+void run(const char* name, Cache& cache, const std::vector<int>& trace, const std::vector<size_t>& sizes) {
+    std::printf("%s\n  %10s %14s %14s\n", name, "ops", "value MB", "heap MB");
+    const long long base = live_bytes.load();
+    size_t held = 0;   // value bytes, tracked independently of the cache
+    long long peak = 0;
+    auto start = bench::Clock::now();
+    for (size_t i = 0; i < trace.size(); ++i) {
+        int k = trace[i];
+        if (!cache.try_get(k)) cache.put(k, std::string(sizes[static_cast<size_t>(k)], 'v'));
+        peak = std::max(peak, live_bytes.load(std::memory_order_relaxed) - base);
+        if ((i + 1) % (trace.size() / 5) == 0) {
+            held = 0;
+            for (int key = 0; key < static_cast<int>(sizes.size()); ++key)
+                if (const std::string* v = cache.peek(key)) held += v->size();
+            std::printf("  %10zu %14.1f %14.1f\n", i + 1, held / 1048576.0,
+                        (live_bytes.load() - base) / 1048576.0);
+        }
+    }
+    double ns = bench::nanos_since(start) / static_cast<double>(trace.size());
+    std::printf("  peak heap %.1f MB, %.1f ns/op (including value construction)\n", peak / 1048576.0, ns);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t ops = static_cast<size_t>(bench::arg_or(argc, argv, "ops", 2000000));
+    const size_t keys = static_cast<size_t>(bench::arg_or(argc, argv, "keys", 200000));
+    const size_t budget = static_cast<size_t>(bench::arg_or(argc, argv, "budget_mb", 16)) << 20;
+    const double alpha = bench::arg_or(argc, argv, "alpha_x100", 120) / 100.0;
+
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<size_t> sizes(keys);
+    double mean = 0;
+    for (auto& s : sizes) {
+        s = std::min<size_t>(static_cast<size_t>(64.0 / std::pow(1.0 - u(rng), 1.0 / alpha)), 512 * 1024);
+        mean += static_cast<double>(s) / keys;
+    }
+    std::vector<size_t> sorted(sizes);
+    const size_t median = bench::percentile(sorted, 50);
+    bench::Zipf zipf(keys, 0.9);
+    std::vector<int> trace(ops);
+    for (auto& k : trace) k = static_cast<int>(zipf(u(rng)));
+    // Hot ranks map to random keys, so popularity and size are independent.
+    std::vector<int> perm(keys);
+    for (size_t i = 0; i < keys; ++i) perm[i] = static_cast<int>(i);
+    std::shuffle(perm.begin(), perm.end(), rng);
+    for (auto& k : trace) k = perm[static_cast<size_t>(k)];
+
+    const size_t entries = std::max<size_t>(1, budget / median);
+    std::printf("budget %zu MB, value median %zu B, mean %.0f B, Pareto alpha %.2f, %zu keys, %zu ops\n\n",
+                budget >> 20, median, mean, alpha, keys, ops);
+    {
+        LRUCache<int, std::string> by_count(entries);
+        char title[64];
+        std::snprintf(title, sizeof(title), "entry-count LRUCache (%zu entries)", entries);
+        run(title, by_count, trace, sizes);
+    }
+    {
+        WeightedLRUCache<int, std::string, LengthWeigher> by_bytes(budget);
+        run("weighted LRUCache (value bytes)", by_bytes, trace, sizes);
+    }
+    return 0;
+}
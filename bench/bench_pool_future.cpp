@@ -0,0 +1,73 @@
+// Layered dependency graph (width x depth, each node depending on two nodes
+// of the previous layer) executed two ways:
+//   blocking: every node is an enqueue'd task that calls get() on its
+//             dependencies' shared_futures, parking its worker meanwhile
+//   graph:    TaskGraph schedules each node when its last dependency ends
+//
+// Usage: bench_pool_future [width=64] [depth=64] [threads=N] [work=200]
+#include "PoolFuture.h"
+#include "bench_util.h"
+
+#include <cstdio>
+#include <future>
+#include <vector>
+
+namespace {
+
+void spin_work(int iterations) {
+    volatile int x = 0;
+    for (int i = 0; i < iterations; ++i) x = x + i;
+}
+
+double run_blocking(size_t threads, int width, int depth, int work) {
+    SimpleThreadPool pool(threads);
+    auto start = bench::Clock::now();
+    std::vector<std::shared_future<void>> prev, cur;
+    for (int d = 0; d < depth; ++d) {
+        cur.clear();
+        for (int w = 0; w < width; ++w) {
+            std::vector<std::shared_future<void>> deps;
+            if (d > 0) deps = {prev[w], prev[(w + 1) % width]};
+            cur.push_back(pool.enqueue([deps, work] {
+                for (auto& dep : deps) dep.get();
+                spin_work(work);
+            }).share());
+        }
+        prev.swap(cur);
+    }
+    for (auto& f : prev) f.get();
+    return bench::seconds_since(start);
+}
+
+double run_graph(size_t threads, int width, int depth, int work) {
+    SimpleThreadPool pool(threads);
+    TaskGraph graph;
+    std::vector<TaskGraph::NodeId> prev, cur;
+    for (int d = 0; d < depth; ++d) {
+        cur.clear();
+        for (int w = 0; w < width; ++w) {
+            std::vector<TaskGraph::NodeId> deps;
+            if (d > 0) deps = {prev[w], prev[(w + 1) % width]};
+            cur.push_back(graph.add([work] { spin_work(work); }, deps));
+        }
+        prev.swap(cur);
+    }
+    auto start = bench::Clock::now();
+    graph.run(pool).get();
+    return bench::seconds_since(start);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int width = static_cast<int>(bench::arg_or(argc, argv, "width", 64));
+    const int depth = static_cast<int>(bench::arg_or(argc, argv, "depth", 64));
+    const int work = static_cast<int>(bench::arg_or(argc, argv, "work", 200));
+    const size_t threads = static_cast<size_t>(bench::arg_or(argc, argv, "threads", bench::hardware_threads()));
+
+    std::printf("%dx%d graph, %zu workers\n", width, depth, threads);
+    std::printf("%-12s %12s\n", "scheduler", "ms");
+    std::printf("%-12s %12.2f\n", "blocking", run_blocking(threads, width, depth, work) * 1e3);
+    std::printf("%-12s %12.2f\n", "graph", run_graph(threads, width, depth, work) * 1e3);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Peak memory and producer latency under sustained 10x overload.
+//
+// `producers` threads submit tasks carrying a `payload`-byte buffer at ten
+// times the rate the workers can retire them (each task spins for work_us).
+// Every overflow policy runs in its own forked child so the peak RSS it
+// reports (VmHWM) is its own; "unbounded" is the pool without max_queued.
+//
+// Usage: bench_threadpool_backpressure [seconds=2] [threads=N] [producers=2]
+//        [work_us=20] [capacity=1024] [payload=1024]
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Config {
+    double seconds;
+    size_t threads, producers, capacity, payload;
+    long long work_ns;
+};
+
+void spin_for(long long nanos) {
+    auto start = bench::Clock::now();
+    while (bench::nanos_since(start) < nanos) {}
+}
+
+long peak_rss_kb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::atol(line.c_str() + 6);
+    return -1;
+}
+
+void run(const char* name, bool bounded, OverflowPolicy policy, const Config& cfg) {
+    ThreadPoolOptions opts;
+    if (bounded) {
+        opts.max_queued = cfg.capacity;
+        opts.overflow = policy;
+    }
+    SimpleThreadPool pool(cfg.threads, opts);
+    std::atomic<long> done{0}, rejected{0};
+    std::mutex mutex;
+    bench::LatencyHistogram latency;
+
+    // Workers retire about threads / work time tasks per second; offer ten times that.
+    const double offered = 10.0 * cfg.threads * 1e9 / cfg.work_ns;
+    const long long gap_ns = static_cast<long long>(1e9 * cfg.producers / offered);
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < cfg.producers; ++p) {
+        producers.emplace_back([&] {
+            bench::LatencyHistogram local;
+            auto start = bench::Clock::now();
+            long long next = 0;
+            while (bench::seconds_since(start) < cfg.seconds) {
+                while (bench::nanos_since(start) < next) {}
+                next += gap_ns;
+                std::vector<char> buffer(cfg.payload, 1);
+                auto t0 = bench::Clock::now();
+                try {
+                    pool.post([&done, work = cfg.work_ns, buffer = std::move(buffer)] {
+                        spin_for(work);
+                        bench::do_not_optimize(buffer.data());
+                        done.fetch_add(1);
+                    });
+                } catch (const QueueFullError&) {
+                    rejected.fetch_add(1);
+                }
+                local.record(bench::nanos_since(t0));
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            latency.merge(local);
+        });
+    }
+    for (auto& t : producers) t.join();
+    pool.shutdown(ShutdownPolicy::Discard);
+    std::printf("== %s == completed=%ld rejected=%ld peak_rss=%ldKB\n", name, done.load(), rejected.load(),
+                peak_rss_kb());
+    latency.print("submit latency");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config cfg;
+    cfg.seconds = static_cast<double>(bench::arg_or(argc, argv, "seconds", 2));
+    cfg.threads = static_cast<size_t>(bench::arg_or(argc, argv, "threads", bench::hardware_threads()));
+    cfg.producers = static_cast<size_t>(bench::arg_or(argc, argv, "producers", 2));
+    cfg.work_ns = bench::arg_or(argc, argv, "work_us", 20) * 1000;
+    cfg.capacity = static_cast<size_t>(bench::arg_or(argc, argv, "capacity", 1024));
+    cfg.payload = static_cast<size_t>(bench::arg_or(argc, argv, "payload", 1024));
+
+    struct Variant { const char* name; bool bounded; OverflowPolicy policy; };
+    const Variant variants[] = {
+        {"unbounded", false, OverflowPolicy::Block},
+        {"block", true, OverflowPolicy::Block},
+        {"reject", true, OverflowPolicy::Reject},
+        {"caller-runs", true, OverflowPolicy::CallerRuns},
+        {"drop-oldest", true, OverflowPolicy::DropOldest},
+    };
+    for (const Variant& v : variants) {
+        std::fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) {
+            run(v.name, v.bounded, v.policy, cfg);
+            std::fflush(stdout);
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+    }
+    return 0;
+}
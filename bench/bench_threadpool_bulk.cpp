@@ -0,0 +1,43 @@
+// Per-item overhead of fanning out a loop: one enqueue per element vs
+// enqueue_bulk vs parallel_for with automatic chunking.
+//
+// Usage: bench_threadpool_bulk [items=1000000] [threads=N]
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const size_t items = static_cast<size_t>(bench::arg_or(argc, argv, "items", 1000000));
+    const size_t threads = static_cast<size_t>(bench::arg_or(argc, argv, "threads", bench::hardware_threads()));
+    std::vector<double> data(items, 1.0);
+    SimpleThreadPool pool(threads);
+
+    std::printf("%zu items, %zu workers\n", items, threads);
+    std::printf("%-22s %12s\n", "strategy", "ns/item");
+
+    {
+        auto start = bench::Clock::now();
+        std::vector<std::future<void>> futures;
+        futures.reserve(items);
+        for (size_t i = 0; i < items; ++i)
+            futures.push_back(pool.enqueue([&data, i] { data[i] *= 1.000001; }));
+        for (auto& f : futures) f.get();
+        std::printf("%-22s %12.1f\n", "enqueue loop", bench::nanos_since(start) / double(items));
+    }
+    {
+        auto start = bench::Clock::now();
+        auto futures = pool.enqueue_bulk(items, [&data](size_t i) { data[i] *= 1.000001; });
+        for (auto& f : futures) f.get();
+        std::printf("%-22s %12.1f\n", "enqueue_bulk", bench::nanos_since(start) / double(items));
+    }
+    {
+        auto start = bench::Clock::now();
+        pool.parallel_for(size_t(0), items, size_t(0), [&data](size_t i) { data[i] *= 1.000001; });
+        std::printf("%-22s %12.1f\n", "parallel_for (auto)", bench::nanos_since(start) / double(items));
+    }
+    bench::do_not_optimize(data[items / 2]);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Bursty load against fixed-size and elastic pools.
+//
+// Each cycle submits a burst of `burst` blocking-ish tasks (work_us of sleep,
+// standing in for I/O) and then stays quiet for `gap_ms`. Reports total
+// queue-wait latency and samples the running thread count every 10ms, so the
+// elastic pool can be seen growing into bursts and retiring between them.
+//
+// Usage: bench_threadpool_elastic [cycles=5] [burst=400] [work_us=500] [gap_ms=300] [min=2] [max=16]
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Config {
+    long long cycles, burst, work_us, gap_ms;
+    size_t min_threads, max_threads;
+};
+
+void run(const char* name, size_t threads, const ThreadPoolOptions& opts, const Config& cfg) {
+    SimpleThreadPool pool(threads, opts);
+    std::mutex mutex;
+    bench::LatencyHistogram wait;
+    std::atomic<long> outstanding{0};
+    std::atomic<bool> sampling{true};
+    std::vector<size_t> sizes;
+
+    std::thread sampler([&] {
+        while (sampling.load()) {
+            sizes.push_back(pool.size());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    auto start = bench::Clock::now();
+    for (long long c = 0; c < cfg.cycles; ++c) {
+        for (long long i = 0; i < cfg.burst; ++i) {
+            auto queued = bench::Clock::now();
+            outstanding.fetch_add(1);
+            pool.post([&, queued] {
+                long long waited = bench::nanos_since(queued);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    wait.record(waited);
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(cfg.work_us));
+                outstanding.fetch_sub(1);
+            });
+        }
+        while (outstanding.load() > 0) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        std::this_thread::sleep_for(std::chrono::milliseconds(cfg.gap_ms));
+    }
+    double elapsed = bench::seconds_since(start);
+    sampling = false;
+    sampler.join();
+
+    size_t peak = 0;
+    double mean = 0;
+    for (size_t s : sizes) {
+        peak = std::max(peak, s);
+        mean += static_cast<double>(s);
+    }
+    if (!sizes.empty()) mean /= static_cast<double>(sizes.size());
+    std::printf("== %s == %.2fs, threads mean=%.1f peak=%zu end=%zu\n", name, elapsed, mean, peak, pool.size());
+    wait.print("queue wait");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config cfg;
+    cfg.cycles = bench::arg_or(argc, argv, "cycles", 5);
+    cfg.burst = bench::arg_or(argc, argv, "burst", 400);
+    cfg.work_us = bench::arg_or(argc, argv, "work_us", 500);
+    cfg.gap_ms = bench::arg_or(argc, argv, "gap_ms", 300);
+    cfg.min_threads = static_cast<size_t>(bench::arg_or(argc, argv, "min", 2));
+    cfg.max_threads = static_cast<size_t>(bench::arg_or(argc, argv, "max", 16));
+
+    run("fixed min", cfg.min_threads, ThreadPoolOptions(), cfg);
+    run("fixed max", cfg.max_threads, ThreadPoolOptions(), cfg);
+
+    ThreadPoolOptions elastic;
+    elastic.max_threads = cfg.max_threads;
+    elastic.min_threads = cfg.min_threads;
+    elastic.grow_after = std::chrono::microseconds(cfg.work_us);
+    elastic.idle_timeout = std::chrono::milliseconds(cfg.gap_ms / 3 + 1);
+    run("elastic", cfg.min_threads, elastic, cfg);
+    return 0;
+}
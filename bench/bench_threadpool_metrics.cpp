@@ -0,0 +1,66 @@
+// Cost of the instrumentation layer. Built twice: bench_threadpool_metrics
+// (compiled out) and bench_threadpool_metrics_on (SIMPLE_THREAD_POOL_METRICS);
+// compare their throughput for tiny and for 1us tasks. The instrumented build
+// also prints the snapshot it collected.
+//
+// Usage: bench_threadpool_metrics[_on] [tasks=1000000] [threads=N] [rounds=3]
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+void spin_for(long long nanos) {
+    auto start = bench::Clock::now();
+    while (bench::nanos_since(start) < nanos) {}
+}
+
+void run(const char* name, size_t threads, long tasks, long long work_ns, int rounds) {
+    double best = 0;
+    for (int r = 0; r < rounds; ++r) {
+        SimpleThreadPool pool(threads);
+        std::atomic<long> done{0};
+        auto start = bench::Clock::now();
+        for (long i = 0; i < tasks; ++i) {
+            pool.post([&done, work_ns] {
+                if (work_ns) spin_for(work_ns);
+                done.fetch_add(1, std::memory_order_release);
+            });
+        }
+        while (done.load(std::memory_order_acquire) < tasks) std::this_thread::yield();
+        best = std::max(best, tasks / bench::seconds_since(start));
+#ifdef SIMPLE_THREAD_POOL_METRICS
+        if (r == rounds - 1) {
+            auto s = pool.metrics_snapshot();
+            std::printf("  %s: tasks=%llu wait p50=%lluns p99=%lluns run p50=%lluns p99=%lluns util=%.2f\n", name,
+                        static_cast<unsigned long long>(s.tasks()),
+                        static_cast<unsigned long long>(s.queue_wait.percentile(50)),
+                        static_cast<unsigned long long>(s.queue_wait.percentile(99)),
+                        static_cast<unsigned long long>(s.run_time.percentile(50)),
+                        static_cast<unsigned long long>(s.run_time.percentile(99)), s.utilization(pool.size()));
+        }
+#endif
+    }
+    std::printf("%-10s %12.0f tasks/s (best of %d)\n", name, best, rounds);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long tasks = bench::arg_or(argc, argv, "tasks", 1000000);
+    const size_t threads = static_cast<size_t>(bench::arg_or(argc, argv, "threads", bench::hardware_threads()));
+    const int rounds = static_cast<int>(bench::arg_or(argc, argv, "rounds", 3));
+
+#ifdef SIMPLE_THREAD_POOL_METRICS
+    std::printf("metrics: enabled\n");
+#else
+    std::printf("metrics: compiled out\n");
+#endif
+    run("empty", threads, tasks, 0, rounds);
+    run("1us", threads, tasks / 4, 1000, rounds);
+    return 0;
+}
@@ -0,0 +1,49 @@
+// Throughput of fire-and-forget post() vs enqueue() with a discarded future.
+//
+// Usage: bench_threadpool_post [tasks=1000000] [threads=N] [producers=1]
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template<class Submit>
+double run(size_t threads, int producers, long tasks, Submit submit) {
+    SimpleThreadPool pool(threads);
+    std::atomic<long> done{0};
+    auto start = bench::Clock::now();
+    std::vector<std::thread> submitters;
+    for (int p = 0; p < producers; ++p)
+        submitters.emplace_back([&] {
+            for (long i = 0; i < tasks / producers; ++i) submit(pool, done);
+        });
+    for (auto& t : submitters) t.join();
+    const long total = (tasks / producers) * producers;
+    while (done.load(std::memory_order_acquire) < total) std::this_thread::yield();
+    return total / bench::seconds_since(start);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long tasks = bench::arg_or(argc, argv, "tasks", 1000000);
+    const size_t threads = static_cast<size_t>(bench::arg_or(argc, argv, "threads", bench::hardware_threads()));
+    const int producers = static_cast<int>(bench::arg_or(argc, argv, "producers", 1));
+
+    auto via_enqueue = [](SimpleThreadPool& pool, std::atomic<long>& done) {
+        pool.enqueue([&done] { done.fetch_add(1, std::memory_order_release); });
+    };
+    auto via_post = [](SimpleThreadPool& pool, std::atomic<long>& done) {
+        pool.post([&done] { done.fetch_add(1, std::memory_order_release); });
+    };
+
+    std::printf("%ld tasks, %zu workers, %d producers\n", tasks, threads, producers);
+    std::printf("%-10s %14s\n", "api", "tasks/s");
+    std::printf("%-10s %14.0f\n", "enqueue", run(threads, producers, tasks, via_enqueue));
+    std::printf("%-10s %14.0f\n", "post", run(threads, producers, tasks, via_post));
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Queue-wait latency per priority while Background work saturates the pool.
+//
+// A flood producer keeps the queue loaded with Background tasks; a probe
+// producer submits an Interactive and a Normal task every `interval_us`. The
+// run is repeated with every task at Normal priority (single FIFO) to show
+// what the lanes buy.
+//
+// Usage: bench_threadpool_priority [seconds=2] [threads=N] [work_us=50] [interval_us=500]
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+void spin_for(long long nanos) {
+    auto start = bench::Clock::now();
+    while (bench::nanos_since(start) < nanos) {}
+}
+
+struct Recorder {
+    std::mutex mutex;
+    bench::LatencyHistogram hist;
+    void add(long long nanos) {
+        std::lock_guard<std::mutex> lock(mutex);
+        hist.record(nanos);
+    }
+};
+
+void run(bool use_lanes, size_t threads, double seconds, long long work_ns, long long interval_ns) {
+    SimpleThreadPool pool(threads);
+    Recorder interactive, normal, background;
+    std::atomic<bool> running{true};
+    std::atomic<long> outstanding{0};
+
+    auto submit = [&](TaskPriority p, Recorder& rec, long long work) {
+        SubmitOptions opts;
+        opts.priority = use_lanes ? p : TaskPriority::Normal;
+        auto queued = bench::Clock::now();
+        outstanding.fetch_add(1);
+        pool.post_with(opts, [&rec, &outstanding, queued, work] {
+            rec.add(bench::nanos_since(queued));
+            spin_for(work);
+            outstanding.fetch_sub(1);
+        });
+    };
+
+    std::thread flood([&] {
+        while (running.load()) {
+            if (outstanding.load() < static_cast<long>(threads * 64)) submit(TaskPriority::Background, background, work_ns);
+            else std::this_thread::yield();
+        }
+    });
+    std::thread probe([&] {
+        while (running.load()) {
+            submit(TaskPriority::Interactive, interactive, work_ns / 10);
+            submit(TaskPriority::Normal, normal, work_ns / 10);
+            std::this_thread::sleep_for(std::chrono::nanoseconds(interval_ns));
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    flood.join();
+    probe.join();
+    while (outstanding.load() > 0) std::this_thread::yield();
+
+    std::printf("== %s ==\n", use_lanes ? "priority lanes" : "single FIFO (all Normal)");
+    interactive.hist.print("interactive");
+    normal.hist.print("normal");
+    background.hist.print("background");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = static_cast<double>(bench::arg_or(argc, argv, "seconds", 2));
+    const size_t threads = static_cast<size_t>(bench::arg_or(argc, argv, "threads", bench::hardware_threads()));
+    const long long work_ns = bench::arg_or(argc, argv, "work_us", 50) * 1000;
+    const long long interval_ns = bench::arg_or(argc, argv, "interval_us", 500) * 1000;
+
+    run(false, threads, seconds, work_ns, interval_ns);
+    run(true, threads, seconds, work_ns, interval_ns);
+    return 0;
+}
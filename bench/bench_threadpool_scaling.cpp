@@ -0,0 +1,88 @@
+// Tasks/sec for SharedQueue vs WorkStealing scheduling, 1..N workers, with
+// the original mutex + std::queue + condvar pool (BaselineThreadPool) as the
+// reference column for each workload.
+//
+//   flat: one external thread submits every task (global queue only)
+//   fork: tasks recursively spawn children from inside the pool, which is
+//         where per-worker deques avoid the shared queue_mutex
+//
+// Usage: bench_threadpool_scaling [tasks=N] [depth=D]
+#include "BaselineThreadPool.h"
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+
+namespace {
+
+void spin_until(const std::atomic<long>& counter, long target) {
+    while (counter.load(std::memory_order_acquire) < target) std::this_thread::yield();
+}
+
+template<class Pool>
+double run_flat(Pool& pool, long tasks) {
+    std::atomic<long> done{0};
+    auto start = bench::Clock::now();
+    for (long i = 0; i < tasks; ++i)
+        pool.enqueue([&done] { done.fetch_add(1, std::memory_order_release); });
+    spin_until(done, tasks);
+    return tasks / bench::seconds_since(start);
+}
+
+template<class Pool>
+void fork(Pool& pool, std::atomic<long>& done, int depth) {
+    if (depth > 0) {
+        pool.enqueue([&pool, &done, depth] { fork(pool, done, depth - 1); });
+        pool.enqueue([&pool, &done, depth] { fork(pool, done, depth - 1); });
+    }
+    done.fetch_add(1, std::memory_order_release);
+}
+
+template<class Pool>
+double run_fork(Pool& pool, int depth) {
+    std::atomic<long> done{0};
+    const long total = (1L << (depth + 1)) - 1;
+    auto start = bench::Clock::now();
+    pool.enqueue([&pool, &done, depth] { fork(pool, done, depth); });
+    spin_until(done, total);
+    return total / bench::seconds_since(start);
+}
+
+// Throughput of `run` on a fresh pool of `threads` workers in `mode`.
+template<class Run>
+double on_pool(SchedulingMode mode, size_t threads, Run run) {
+    ThreadPoolOptions opts;
+    opts.mode = mode;
+    SimpleThreadPool pool(threads, opts);
+    return run(pool);
+}
+
+template<class Run>
+double on_baseline(size_t threads, Run run) {
+    BaselineThreadPool pool(threads);
+    return run(pool);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long tasks = bench::arg_or(argc, argv, "tasks", 200000);
+    const int depth = static_cast<int>(bench::arg_or(argc, argv, "depth", 17));
+
+    auto flat = [tasks](auto& pool) { return run_flat(pool, tasks); };
+    auto forked = [depth](auto& pool) { return run_fork(pool, depth); };
+
+    std::printf("%-8s %16s %16s %16s %16s %16s %16s\n", "threads", "flat baseline/s", "flat shared/s",
+                "flat stealing/s", "fork baseline/s", "fork shared/s", "fork stealing/s");
+    for (size_t n : bench::thread_counts(bench::hardware_threads())) {
+        std::printf("%-8zu %16.0f %16.0f %16.0f %16.0f %16.0f %16.0f\n", n,
+                    on_baseline(n, flat),
+                    on_pool(SchedulingMode::SharedQueue, n, flat),
+                    on_pool(SchedulingMode::WorkStealing, n, flat),
+                    on_baseline(n, forked),
+                    on_pool(SchedulingMode::SharedQueue, n, forked),
+                    on_pool(SchedulingMode::WorkStealing, n, forked));
+    }
+    return 0;
+}
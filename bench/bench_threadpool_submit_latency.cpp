@@ -0,0 +1,64 @@
+// Per-call enqueue latency with concurrent producers: the lock-free ring
+// queue in SimpleThreadPool vs the original mutex + condvar queue.
+//
+// Usage: bench_threadpool_submit_latency [producers=8] [tasks=100000] [threads=N]
+#include "BaselineThreadPool.h"
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template<class Pool>
+void run(const char* name, Pool& pool, int producers, long tasks_per_producer) {
+    std::atomic<long> done{0};
+    std::vector<std::vector<long long>> latencies(producers);
+    std::vector<std::thread> threads;
+    auto start = bench::Clock::now();
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            auto& samples = latencies[p];
+            samples.reserve(tasks_per_producer);
+            for (long i = 0; i < tasks_per_producer; ++i) {
+                auto t0 = bench::Clock::now();
+                pool.enqueue([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+                samples.push_back(bench::nanos_since(t0));
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    const long total = producers * tasks_per_producer;
+    while (done.load() < total) std::this_thread::yield();
+    double secs = bench::seconds_since(start);
+
+    std::vector<long long> all;
+    for (auto& v : latencies) all.insert(all.end(), v.begin(), v.end());
+    long long p50 = bench::percentile(all, 50);
+    long long p99 = bench::percentile(all, 99);
+    long long p999 = bench::percentile(all, 99.9);
+    std::printf("%-16s %10lld %10lld %10lld %14.0f\n", name, p50, p99, p999, total / secs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int producers = static_cast<int>(bench::arg_or(argc, argv, "producers", 8));
+    const long tasks = bench::arg_or(argc, argv, "tasks", 100000);
+    const size_t threads = static_cast<size_t>(bench::arg_or(argc, argv, "threads", bench::hardware_threads()));
+
+    std::printf("%d producers, %ld tasks each, %zu workers\n", producers, tasks, threads);
+    std::printf("%-16s %10s %10s %10s %14s\n", "queue", "p50 ns", "p99 ns", "p99.9 ns", "tasks/s");
+    {
+        BaselineThreadPool pool(threads);
+        run("mutex+condvar", pool, producers, tasks);
+    }
+    {
+        SimpleThreadPool pool(threads);
+        run("lock-free ring", pool, producers, tasks);
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Timer insert/cancel throughput and firing jitter.
+//
+// Part one schedules `timers` timers at random expiries up to ~1 hour out and
+// cancels them all, first on a bare TimerWheel and then through the pool's
+// schedule_after/cancel_timer (which adds the lock). Part two arms `jitter`
+// one-shot timers 1..`max_ms` ms ahead and records how late each one fires,
+// measured when its callback starts on a worker.
+//
+// Usage: bench_timer_wheel [timers=1000000] [jitter=2000] [max_ms=500] [threads=N]
+#include "SimpleThreadPool.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, "timers", 1000000));
+    const size_t jitter_count = static_cast<size_t>(bench::arg_or(argc, argv, "jitter", 2000));
+    const long long max_ms = bench::arg_or(argc, argv, "max_ms", 500);
+    const size_t threads = static_cast<size_t>(bench::arg_or(argc, argv, "threads", bench::hardware_threads()));
+
+    std::mt19937_64 rng(1);
+    std::vector<uint64_t> ticks(count);
+    for (auto& t : ticks) t = 1 + rng() % 3600000;
+
+    {
+        TimerWheel<int> wheel;
+        std::vector<TimerWheel<int>::Id> ids(count);
+        auto start = bench::Clock::now();
+        for (size_t i = 0; i < count; ++i) ids[i] = wheel.schedule(ticks[i], 0);
+        double insert = bench::nanos_since(start) / static_cast<double>(count);
+        start = bench::Clock::now();
+        for (auto id : ids) wheel.cancel(id);
+        double cancel = bench::nanos_since(start) / static_cast<double>(count);
+        std::printf("TimerWheel:   %zu timers  insert %.1f ns/op  cancel %.1f ns/op\n", count, insert, cancel);
+    }
+    {
+        SimpleThreadPool pool(threads);
+        std::vector<TimerId> ids(count);
+        auto start = bench::Clock::now();
+        for (size_t i = 0; i < count; ++i) ids[i] = pool.schedule_after(std::chrono::milliseconds(ticks[i]), [] {});
+        double insert = bench::nanos_since(start) / static_cast<double>(count);
+        start = bench::Clock::now();
+        for (auto id : ids) pool.cancel_timer(id);
+        double cancel = bench::nanos_since(start) / static_cast<double>(count);
+        std::printf("pool timers:  %zu timers  schedule %.1f ns/op  cancel %.1f ns/op\n", count, insert, cancel);
+    }
+    {
+        SimpleThreadPool pool(threads);
+        std::mutex mutex;
+        bench::LatencyHistogram late;
+        std::atomic<size_t> fired{0};
+        for (size_t i = 0; i < jitter_count; ++i) {
+            auto target = bench::Clock::now() + std::chrono::milliseconds(1 + static_cast<long long>(rng() % max_ms));
+            pool.schedule_at(target, [&, target] {
+                long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(bench::Clock::now() - target).count();
+                std::lock_guard<std::mutex> lock(mutex);
+                late.record(ns);
+                fired.fetch_add(1);
+            });
+        }
+        while (fired.load() < jitter_count) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::printf("firing lateness (tick = 1ms):\n");
+        late.print("lateness");
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+// Minimal timing helpers shared by the micro-benchmarks in this directory.
+// Benchmarks are plain executables; each prints a small table to stdout.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+inline long long nanos_since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// Value of `name=<n>` from argv, or `fallback`.
+inline long long arg_or(int argc, char** argv, const char* name, long long fallback) {
+    const std::string prefix = std::string(name) + "=";
+    for (int i = 1; i < argc; ++i) {
+        std::string a(argv[i]);
+        if (a.compare(0, prefix.size(), prefix) == 0) return std::atoll(a.c_str() + prefix.size());
+    }
+    return fallback;
+}
+
+// Value of `name=<text>` from argv, or `fallback`.
+inline std::string arg_str(int argc, char** argv, const char* name, const std::string& fallback) {
+    const std::string prefix = std::string(name) + "=";
+    for (int i = 1; i < argc; ++i) {
+        std::string a(argv[i]);
+        if (a.compare(0, prefix.size(), prefix) == 0) return a.substr(prefix.size());
+    }
+    return fallback;
+}
+
+inline size_t hardware_threads() {
+    size_t n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// 1, 2, 4, ... up to and including `max`.
+inline std::vector<size_t> thread_counts(size_t max) {
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < max; n *= 2) counts.push_back(n);
+    counts.push_back(max);
+    return counts;
+}
+
+// Percentile (0..100) of a sample set; sorts in place.
+template<class T>
+T percentile(std::vector<T>& samples, double p) {
+    if (samples.empty()) return T();
+    std::sort(samples.begin(), samples.end());
+    size_t idx = static_cast<size_t>(p / 100.0 * (samples.size() - 1) + 0.5);
+    return samples[std::min(idx, samples.size() - 1)];
+}
+
+// Power-of-two bucketed latency histogram (bucket k holds [2^k, 2^(k+1)) us).
+class LatencyHistogram {
+public:
+    void record(long long nanos) {
+        long long us = nanos / 1000;
+        size_t bucket = 0;
+        while (us > 1 && bucket + 1 < buckets.size()) { us >>= 1; ++bucket; }
+        ++buckets[bucket];
+        samples.push_back(nanos);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t b = 0; b < buckets.size(); ++b) buckets[b] += other.buckets[b];
+        samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+    }
+
+    void print(const char* name) {
+        std::printf("%s: n=%zu p50=%.1fus p99=%.1fus p99.9=%.1fus\n", name, samples.size(),
+                    percentile(samples, 50) / 1e3, percentile(samples, 99) / 1e3,
+                    percentile(samples, 99.9) / 1e3);
+        for (size_t b = 0; b < buckets.size(); ++b) {
+            if (buckets[b] == 0) continue;
+            std::printf("  <%8lluus %10zu\n", 2ull << b, buckets[b]);
+        }
+    }
+
+private:
+    std::vector<size_t> buckets = std::vector<size_t>(32, 0);
+    std::vector<long long> samples;
+};
+
+// Zipf-distributed integers in [0, n): rank k is drawn with probability
+// proportional to 1 / (k + 1)^s. Inverts a precomputed CDF, so construction is
+// O(n) and each draw a binary search.
+class Zipf {
+public:
+    Zipf(size_t n, double s) : cdf(n) {
+        double sum = 0;
+        for (size_t k = 0; k < n; ++k) cdf[k] = sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+        for (auto& c : cdf) c /= sum;
+    }
+
+    // `u` uniform in [0, 1).
+    size_t operator()(double u) const {
+        return std::min(static_cast<size_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()), cdf.size() - 1);
+    }
+
+private:
+    std::vector<double> cdf;
+};
+
+// Keeps the optimizer from discarding a computed value.
+template<class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,286 @@
+#ifndef CACHE_POLICY_H
+#define CACHE_POLICY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Eviction and admission policies for LRUCache.
+//
+// The cache owns its entries and the key index; a policy owns their order.
+// Every entry embeds a CacheHook, and the cache reports events on it:
+//
+//   Policy(capacity)          capacity in weight units (entries unless the
+//                             cache has a weigher)
+//   on_hit(hook)              a lookup found the entry
+//   on_miss(hash)             a lookup for a key with this hash missed
+//   on_insert(hook)           a new entry was added
+//   on_erase(hook)            the cache is removing the entry itself
+//   evict() -> hook           the cache needs room for an incoming entry:
+//                             detach an entry and return it for disposal
+//   for_each(fn)              visit entries coldest first
+//   restore(hook)             re-add an entry as the hottest of
+//                             hook->segment, skipping admission (copies)
+//
+// Copying a policy copies its configuration and statistics but no entries;
+// the copied cache restore()s them.
+
+struct CacheHook {
+    CacheHook* prev = nullptr;   // towards hotter entries
+    CacheHook* next = nullptr;   // towards colder entries
+    size_t hash = 0;             // the key's hash, as computed by the cache
+    uint8_t segment = 0;         // policy-defined
+    uint32_t weight = 1;         // the entry's share of the capacity
+};
+
+// Intrusive doubly linked list of hooks, hottest at the front.
+class CacheHookList {
+public:
+    CacheHook* front() const { return head; }
+    CacheHook* back() const { return tail; }
+    size_t size() const { return length; }
+    size_t weight() const { return total_weight; }
+    bool empty() const { return length == 0; }
+
+    void push_front(CacheHook* h) {
+        h->prev = nullptr;
+        h->next = head;
+        if (head) head->prev = h;
+        else tail = h;
+        head = h;
+        ++length;
+        total_weight += h->weight;
+    }
+
+    void remove(CacheHook* h) {
+        if (h->prev) h->prev->next = h->next;
+        else head = h->next;
+        if (h->next) h->next->prev = h->prev;
+        else tail = h->prev;
+        --length;
+        total_weight -= h->weight;
+    }
+
+    void move_to_front(CacheHook* h) {
+        if (h == head) return;
+        remove(h);
+        push_front(h);
+    }
+
+    template<class F>
+    void for_each_back_to_front(F&& fn) const {
+        for (CacheHook* h = tail; h; h = h->prev) fn(h);
+    }
+
+private:
+    CacheHook* head = nullptr;
+    CacheHook* tail = nullptr;
+    size_t length = 0;
+    size_t total_weight = 0;
+};
+
+// Plain least-recently-used order: one list, evict from the back.
+class LruPolicy {
+public:
+    explicit LruPolicy(size_t) {}
+    LruPolicy(const LruPolicy&) {}
+    LruPolicy(LruPolicy&&) = default;
+    LruPolicy& operator=(LruPolicy&&) = default;
+
+    void on_hit(CacheHook* h) { order.move_to_front(h); }
+    void on_miss(size_t) {}
+    void on_insert(CacheHook* h) { order.push_front(h); }
+    void on_erase(CacheHook* h) { order.remove(h); }
+
+    CacheHook* evict() {
+        CacheHook* victim = order.back();
+        order.remove(victim);
+        return victim;
+    }
+
+    template<class F>
+    void for_each(F&& fn) const { order.for_each_back_to_front(fn); }
+
+    void restore(CacheHook* h) { order.push_front(h); }
+
+private:
+    CacheHookList order;
+};
+
+// Count-min sketch of recent access frequencies: four rows of saturating
+// 4-bit counters indexed by independent remixes of the key's hash. Once
+// `sample` increments have been recorded every counter is halved, so old
+// popularity fades.
+class FrequencySketch {
+public:
+    static constexpr unsigned depth = 4;
+    static constexpr uint8_t max_count = 15;
+
+    explicit FrequencySketch(size_t capacity) {
+        // Width follows the capacity, capped so huge caches stay affordable.
+        size_t width = 16;
+        while (width < capacity && width < (size_t(1) << 22)) width <<= 1;
+        mask = width - 1;
+        counters.assign(width * depth, 0);
+        sample = 10 * width;
+    }
+
+    void increment(size_t hash) {
+        bool added = false;
+        for (unsigned row = 0; row < depth; ++row) {
+            uint8_t& c = counters[row * (mask + 1) + index(hash, row)];
+            if (c < max_count) {
+                ++c;
+                added = true;
+            }
+        }
+        if (added && ++additions >= sample) reset();
+    }
+
+    uint8_t frequency(size_t hash) const {
+        uint8_t f = max_count;
+        for (unsigned row = 0; row < depth; ++row)
+            f = std::min(f, counters[row * (mask + 1) + index(hash, row)]);
+        return f;
+    }
+
+private:
+    size_t index(size_t hash, unsigned row) const {
+        static constexpr uint64_t seeds[depth] = {0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full,
+                                                  0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull};
+        uint64_t h = (static_cast<uint64_t>(hash) + row) * seeds[row];
+        return static_cast<size_t>(h >> 32) & mask;
+    }
+
+    void reset() {
+        for (auto& c : counters) c >>= 1;
+        additions /= 2;
+    }
+
+    std::vector<uint8_t> counters;
+    size_t mask;
+    size_t sample;
+    size_t additions = 0;
+};
+
+// W-TinyLFU (Einziger, Friedman & Manes). New entries land in a small LRU
+// window (1% of the capacity); the rest is a segmented LRU whose probation
+// segment holds entries on trial and whose protected segment (80% of it)
+// holds entries hit again while on probation. When the window overflows its
+// oldest entry competes with the main space's eviction victim and only
+// stays if the frequency sketch says it is more popular, so a one-off scan
+// over cold keys cannot flush the hot set the way it does under pure LRU.
+// Segment sizes are in weight units, like the capacity.
+class TinyLfuPolicy {
+public:
+    enum Segment : uint8_t { Window, Probation, Protected };
+
+    explicit TinyLfuPolicy(size_t capacity)
+        : window_max(std::max<size_t>(1, capacity / 100)),
+          protected_max((capacity - std::min(capacity, window_max)) * 4 / 5),
+          sketch(capacity) {}
+
+    TinyLfuPolicy(const TinyLfuPolicy& other)
+        : window_max(other.window_max), protected_max(other.protected_max), sketch(other.sketch) {}
+    TinyLfuPolicy(TinyLfuPolicy&&) = default;
+    TinyLfuPolicy& operator=(TinyLfuPolicy&&) = default;
+
+    void on_hit(CacheHook* h) {
+        sketch.increment(h->hash);
+        switch (h->segment) {
+        case Window:
+            window.move_to_front(h);
+            break;
+        case Probation:
+            probation.remove(h);
+            promote(h);
+            break;
+        default:
+            protected_list.move_to_front(h);
+            break;
+        }
+    }
+
+    void on_miss(size_t hash) { sketch.increment(hash); }
+
+    void on_insert(CacheHook* h) {
+        h->segment = Window;
+        window.push_front(h);
+        // While the cache has room, window overflow moves to probation
+        // unopposed; once full, evict() runs the admission contest instead.
+        if (window.weight() > window_max) {
+            CacheHook* oldest = window.back();
+            window.remove(oldest);
+            oldest->segment = Probation;
+            probation.push_front(oldest);
+        }
+    }
+
+    void on_erase(CacheHook* h) { list_of(h).remove(h); }
+
+    CacheHook* evict() {
+        CacheHook* victim = main_victim();
+        if (window.weight() >= window_max && !window.empty()) {
+            CacheHook* candidate = window.back();
+            window.remove(candidate);
+            if (!victim || sketch.frequency(candidate->hash) <= sketch.frequency(victim->hash))
+                return candidate;
+            list_of(victim).remove(victim);
+            candidate->segment = Probation;
+            probation.push_front(candidate);
+            return victim;
+        }
+        if (!victim) victim = window.back();
+        list_of(victim).remove(victim);
+        return victim;
+    }
+
+    template<class F>
+    void for_each(F&& fn) const {
+        probation.for_each_back_to_front(fn);
+        protected_list.for_each_back_to_front(fn);
+        window.for_each_back_to_front(fn);
+    }
+
+    void restore(CacheHook* h) { list_of(h).push_front(h); }
+
+    // Estimated recent accesses of the key with this hash (0..15).
+    unsigned frequency(size_t hash) const { return sketch.frequency(hash); }
+
+private:
+    CacheHookList& list_of(CacheHook* h) {
+        return h->segment == Window ? window : h->segment == Probation ? probation : protected_list;
+    }
+
+    CacheHook* main_victim() const {
+        if (!probation.empty()) return probation.back();
+        return protected_list.back();
+    }
+
+    // Probation hit: move to protected, demoting its oldest if that overflows.
+    void promote(CacheHook* h) {
+        if (protected_max == 0) {
+            probation.push_front(h);
+            return;
+        }
+        h->segment = Protected;
+        protected_list.push_front(h);
+        if (protected_list.weight() > protected_max) {
+            CacheHook* demoted = protected_list.back();
+            protected_list.remove(demoted);
+            demoted->segment = Probation;
+            probation.push_front(demoted);
+        }
+    }
+
+    size_t window_max;
+    size_t protected_max;
+    FrequencySketch sketch;
+    CacheHookList window;
+    CacheHookList probation;
+    CacheHookList protected_list;
+};
+
+#endif
@@ -0,0 +1,405 @@
+#ifndef CACHE_SNAPSHOT_H
+#define CACHE_SNAPSHOT_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "LRUCache.h"
+
+// Snapshots of an LRUCache's contents, for warm restarts.
+//
+// save_snapshot() writes every entry, coldest first, to a binary file:
+//
+//   header   SnapshotHeader (48 bytes): magic, format version, the key and
+//            value codec widths and type tags, entry count, payload size
+//            and a 64-bit checksum of the payload
+//   payload  for each entry, its encoded key then its encoded value
+//
+// in host byte order, so a snapshot is meant for the same platform and the
+// same K and V. It is written to `path`.tmp, synced, and renamed over
+// `path`, with the directory synced after, so readers never see a
+// half-written file and a crash leaves either the old snapshot or the new
+// one. load_snapshot() maps the file and checks the header, the checksum
+// and the layout of every entry (and, for a weighted cache, that each
+// entry fits its capacity) before touching the cache, then replays
+// the entries coldest first, so the hottest end up most recently
+// used: under LruPolicy the recency order is restored exactly (other
+// policies re-admit entries in that order). A snapshot larger than the
+// cache keeps its hottest entries. TTL deadlines are not saved; loaded
+// entries get the cache's default TTL.
+//
+// Keys and values are encoded by SnapshotCodec<T>: trivially copyable types
+// as their bytes, std::string as a 32-bit length and its characters.
+// Specialize it for other types, with encode(), decode(), skip() (step over
+// one encoded value, throwing like decode() on a malformed one), width (the
+// encoded size, or 0 if it varies) and tag (a character naming the kind of
+// type, so that e.g. an int snapshot is not read back as floats).
+
+struct SnapshotError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct SnapshotHeader {
+    static constexpr char expected_magic[8] = {'L', 'R', 'U', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint32_t current_version = 2;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t key_width;     // SnapshotCodec<K>::width
+    uint32_t value_width;   // SnapshotCodec<V>::width
+    uint32_t type_tags;     // SnapshotCodec<K>::tag, then SnapshotCodec<V>::tag << 8
+    uint64_t entries;
+    uint64_t payload_bytes;
+    uint64_t checksum;
+};
+static_assert(sizeof(SnapshotHeader) == 48, "SnapshotHeader layout is part of the file format");
+
+// Payload checksum with XXH64's construction (four 64-bit lanes over
+// 32-byte stripes, then an avalanche), fed incrementally as the payload is
+// written or read.
+class SnapshotChecksum {
+public:
+    void update(const unsigned char* p, size_t n) {
+        total += n;
+        if (buffered) {
+            size_t take = std::min(n, sizeof(buffer) - buffered);
+            std::memcpy(buffer + buffered, p, take);
+            buffered += take;
+            p += take;
+            n -= take;
+            if (buffered < sizeof(buffer)) return;
+            stripe(buffer);
+            buffered = 0;
+        }
+        for (; n >= sizeof(buffer); p += sizeof(buffer), n -= sizeof(buffer)) stripe(p);
+        std::memcpy(buffer, p, n);
+        buffered = n;
+    }
+
+    uint64_t digest() const {
+        uint64_t h;
+        if (total >= sizeof(buffer)) {
+            h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+            for (uint64_t lane : lanes) h = (h ^ round(0, lane)) * p1 + p4;
+        } else {
+            h = p5;
+        }
+        h += total;
+        const unsigned char* p = buffer;
+        size_t n = buffered;
+        for (; n >= 8; p += 8, n -= 8) h = rotl(h ^ round(0, load<uint64_t>(p)), 27) * p1 + p4;
+        if (n >= 4) {
+            h = rotl(h ^ (load<uint32_t>(p) * p1), 23) * p2 + p3;
+            p += 4;
+            n -= 4;
+        }
+        for (; n; ++p, --n) h = rotl(h ^ (*p * p5), 11) * p1;
+        h ^= h >> 33;
+        h *= p2;
+        h ^= h >> 29;
+        h *= p3;
+        return h ^ (h >> 32);
+    }
+
+private:
+    static constexpr uint64_t p1 = 0x9E3779B185EBCA87ull, p2 = 0xC2B2AE3D27D4EB4Full, p3 = 0x165667B19E3779F9ull,
+                              p4 = 0x85EBCA77C2B2AE63ull, p5 = 0x27D4EB2F165667C5ull;
+
+    static uint64_t rotl(uint64_t x, unsigned r) { return (x << r) | (x >> (64 - r)); }
+    static uint64_t round(uint64_t acc, uint64_t input) { return rotl(acc + input * p2, 31) * p1; }
+
+    template<class T>
+    static T load(const unsigned char* p) {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        return v;
+    }
+
+    void stripe(const unsigned char* p) {
+        for (int i = 0; i < 4; ++i) lanes[i] = round(lanes[i], load<uint64_t>(p + 8 * i));
+    }
+
+    uint64_t lanes[4] = {p1 + p2, p2, 0, 0 - p1};
+    unsigned char buffer[32];
+    size_t buffered = 0;
+    uint64_t total = 0;
+};
+
+// Buffered output for save_snapshot(): checksums and writes the payload.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(int fd) : fd(fd) { buffer.reserve(buffer_size); }
+
+    void append(const void* data, size_t n) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        if (buffer.size() + n > buffer_size) flush();
+        if (n >= buffer_size) emit(p, n);
+        else buffer.insert(buffer.end(), p, p + n);
+    }
+
+    void flush() {
+        emit(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    uint64_t bytes() const { return written + buffer.size(); }
+    uint64_t checksum() const { return sum.digest(); }
+
+private:
+    static constexpr size_t buffer_size = size_t(1) << 20;
+
+    void emit(const unsigned char* p, size_t n) {
+        sum.update(p, n);
+        written += n;
+        while (n > 0) {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0) throw SnapshotError(std::string("snapshot write failed: ") + std::strerror(errno));
+            p += w;
+            n -= static_cast<size_t>(w);
+        }
+    }
+
+    int fd;
+    std::vector<unsigned char> buffer;
+    SnapshotChecksum sum;
+    uint64_t written = 0;
+};
+
+// Bounds-checked cursor over a mapped payload.
+class SnapshotReader {
+public:
+    SnapshotReader(const unsigned char* begin, const unsigned char* end) : p(begin), end(end) {}
+
+    const unsigned char* take(size_t n) {
+        if (static_cast<size_t>(end - p) < n) throw SnapshotError("snapshot entry runs past the end of the file");
+        const unsigned char* at = p;
+        p += n;
+        return at;
+    }
+
+    void read(void* dst, size_t n) { std::memcpy(dst, take(n), n); }
+
+    bool at_end() const { return p == end; }
+
+private:
+    const unsigned char* p;
+    const unsigned char* end;
+};
+
+template<class T, class = void>
+struct SnapshotCodec;   // no encoding for T: specialize
+
+template<class T>
+struct SnapshotCodec<T, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+    static constexpr uint32_t width = sizeof(T);
+    // 'b'ool, 'f'loating point, 'i'/'u' signed/unsigned integer, 'e'num, or
+    // 'r'aw bytes of any other type.
+    static constexpr char tag = std::is_same<T, bool>::value        ? 'b'
+                                : std::is_floating_point<T>::value ? 'f'
+                                : std::is_integral<T>::value       ? (std::is_signed<T>::value ? 'i' : 'u')
+                                : std::is_enum<T>::value           ? 'e'
+                                                                   : 'r';
+
+    static void encode(const T& v, SnapshotWriter& out) { out.append(&v, sizeof(T)); }
+
+    static T decode(SnapshotReader& in) {
+        T v;
+        in.read(&v, sizeof(T));
+        return v;
+    }
+
+    static void skip(SnapshotReader& in) { in.take(sizeof(T)); }
+};
+
+template<>
+struct SnapshotCodec<std::string> {
+    static constexpr uint32_t width = 0;   // variable length
+    static constexpr char tag = 's';
+
+    static void encode(const std::string& s, SnapshotWriter& out) {
+        if (s.size() > 0xffffffffu) throw SnapshotError("string too long for a snapshot");
+        const uint32_t n = static_cast<uint32_t>(s.size());
+        out.append(&n, sizeof(n));
+        out.append(s.data(), n);
+    }
+
+    static std::string decode(SnapshotReader& in) {
+        uint32_t n;
+        in.read(&n, sizeof(n));
+        return std::string(reinterpret_cast<const char*>(in.take(n)), n);
+    }
+
+    static void skip(SnapshotReader& in) {
+        uint32_t n;
+        in.read(&n, sizeof(n));
+        in.take(n);
+    }
+};
+
+// SnapshotHeader::type_tags for a cache of K -> V.
+template<class K, class V>
+constexpr uint32_t snapshot_type_tags() {
+    return uint32_t(static_cast<unsigned char>(SnapshotCodec<K>::tag)) |
+           uint32_t(static_cast<unsigned char>(SnapshotCodec<V>::tag)) << 8;
+}
+
+// fsync(), retried on EINTR.
+inline bool snapshot_sync(int fd) {
+    int r;
+    while ((r = ::fsync(fd)) != 0 && errno == EINTR) {}
+    return r == 0;
+}
+
+// Makes a rename into the directory holding `path` durable.
+inline void sync_snapshot_dir(const std::string& path) {
+    const size_t slash = path.rfind('/');
+    const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    const int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) throw SnapshotError("cannot open " + dir + " to sync it: " + std::strerror(errno));
+    const bool synced = snapshot_sync(fd);
+    const int saved = errno;
+    ::close(fd);
+    if (!synced) throw SnapshotError("cannot sync " + dir + ": " + std::strerror(saved));
+}
+
+// Writes `cache` to `path`, replacing any existing file, and returns once
+// the new file is on stable storage. Throws SnapshotError on I/O failure;
+// a failure before the rename leaves an existing `path` untouched.
+template<class Cache>
+void save_snapshot(const Cache& cache, const std::string& path) {
+    using KeyCodec = SnapshotCodec<typename Cache::key_type>;
+    using ValueCodec = SnapshotCodec<typename Cache::mapped_type>;
+
+    const std::string temp = path + ".tmp";
+    const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) throw SnapshotError("cannot create " + temp + ": " + std::strerror(errno));
+    try {
+        SnapshotHeader header{};
+        if (::lseek(fd, sizeof(header), SEEK_SET) < 0)
+            throw SnapshotError(std::string("snapshot seek failed: ") + std::strerror(errno));
+        SnapshotWriter out(fd);
+        uint64_t entries = 0;
+        cache.for_each([&](const auto& key, const auto& value) {
+            KeyCodec::encode(key, out);
+            ValueCodec::encode(value, out);
+            ++entries;
+        });
+        out.flush();
+
+        std::memcpy(header.magic, SnapshotHeader::expected_magic, sizeof(header.magic));
+        header.version = SnapshotHeader::current_version;
+        header.key_width = KeyCodec::width;
+        header.value_width = ValueCodec::width;
+        header.type_tags = snapshot_type_tags<typename Cache::key_type, typename Cache::mapped_type>();
+        header.entries = entries;
+        header.payload_bytes = out.bytes();
+        header.checksum = out.checksum();
+        if (::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+            throw SnapshotError(std::string("snapshot header write failed: ") + std::strerror(errno));
+        if (!snapshot_sync(fd)) throw SnapshotError(std::string("snapshot sync failed: ") + std::strerror(errno));
+    } catch (...) {
+        ::close(fd);
+        ::unlink(temp.c_str());
+        throw;
+    }
+    if (::close(fd) != 0) {
+        ::unlink(temp.c_str());
+        throw SnapshotError(std::string("snapshot close failed: ") + std::strerror(errno));
+    }
+    if (std::rename(temp.c_str(), path.c_str()) != 0) {
+        ::unlink(temp.c_str());
+        throw SnapshotError("cannot rename snapshot to " + path + ": " + std::strerror(errno));
+    }
+    sync_snapshot_dir(path);
+}
+
+// Replays the snapshot at `path` into `cache` (see above) and returns the
+// number of entries read. A missing, truncated, corrupt, malformed or
+// mismatched file throws SnapshotError before the cache is modified, as
+// does an entry too heavy for a weighted cache.
+template<class Cache>
+size_t load_snapshot(Cache& cache, const std::string& path) {
+    using K = typename Cache::key_type;
+    using V = typename Cache::mapped_type;
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw SnapshotError("cannot open " + path + ": " + std::strerror(errno));
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw SnapshotError("cannot stat " + path + ": " + std::strerror(errno));
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        throw SnapshotError(path + " is too short to be a snapshot");
+    }
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) throw SnapshotError("cannot map " + path + ": " + std::strerror(errno));
+    struct Unmap {
+        void* p;
+        size_t n;
+        ~Unmap() { ::munmap(p, n); }
+    } unmap{map, size};
+    ::madvise(map, size, MADV_SEQUENTIAL);
+
+    const unsigned char* base = static_cast<const unsigned char*>(map);
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, SnapshotHeader::expected_magic, sizeof(header.magic)) != 0)
+        throw SnapshotError(path + " is not a cache snapshot");
+    if (header.version != SnapshotHeader::current_version)
+        throw SnapshotError(path + " has unsupported snapshot version " + std::to_string(header.version));
+    if (header.key_width != SnapshotCodec<K>::width || header.value_width != SnapshotCodec<V>::width ||
+        header.type_tags != snapshot_type_tags<K, V>())
+        throw SnapshotError(path + " was saved with different key or value types");
+    if (header.payload_bytes != size - sizeof(header))
+        throw SnapshotError(path + " is truncated or has trailing data");
+    SnapshotChecksum sum;
+    sum.update(base + sizeof(header), size - sizeof(header));
+    if (sum.digest() != header.checksum) throw SnapshotError(path + " failed its checksum");
+
+    // A checksum only proves the payload is what was written. Walk it once,
+    // so a malformed entry fails before the first put instead of leaving the
+    // cache half loaded. Only a weighted cache, whose put() rejects entries
+    // heavier than its capacity, needs the entries decoded for this.
+    constexpr bool weighted = !std::is_same<typename Cache::weigher_type, UnitWeigher>::value;
+    SnapshotReader walk(base + sizeof(header), base + size);
+    for (uint64_t i = 0; i < header.entries; ++i) {
+        if constexpr (weighted) {
+            K key = SnapshotCodec<K>::decode(walk);
+            V value = SnapshotCodec<V>::decode(walk);
+            if (!cache.fits(key, value)) throw SnapshotError(path + " has an entry heavier than the cache capacity");
+        } else {
+            SnapshotCodec<K>::skip(walk);
+            SnapshotCodec<V>::skip(walk);
+        }
+    }
+    if (!walk.at_end()) throw SnapshotError(path + " has more payload than its entry count");
+
+    SnapshotReader in(base + sizeof(header), base + size);
+    cache.reserve(cache.size() + static_cast<size_t>(header.entries));
+    for (uint64_t i = 0; i < header.entries; ++i) {
+        K key = SnapshotCodec<K>::decode(in);
+        V value = SnapshotCodec<V>::decode(in);
+        cache.put(std::move(key), std::move(value));
+    }
+    return static_cast<size_t>(header.entries);
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+// Cooperative cancellation. A CancellationSource hands out tokens; once the
+// source is cancelled every token reports it. Nothing is interrupted: tasks
+// poll cancelled() (or call throw_if_cancelled()) at convenient points, and
+// the pool skips tasks whose token is already cancelled when they come up.
+
+struct OperationCancelled : std::runtime_error {
+    OperationCancelled() : std::runtime_error("operation cancelled") {}
+};
+
+class CancellationToken {
+public:
+    // A default token can never be cancelled.
+    CancellationToken() = default;
+
+    bool cancelled() const { return flag && flag->load(std::memory_order_acquire); }
+    bool can_be_cancelled() const { return flag != nullptr; }
+
+    void throw_if_cancelled() const {
+        if (cancelled()) throw OperationCancelled();
+    }
+
+private:
+    friend class CancellationSource;
+    explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> f) : flag(std::move(f)) {}
+
+    std::shared_ptr<const std::atomic<bool>> flag;
+};
+
+class CancellationSource {
+public:
+    CancellationSource() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    CancellationToken token() const { return CancellationToken(flag); }
+    void cancel() { flag->store(true, std::memory_order_release); }
+    bool cancelled() const { return flag->load(std::memory_order_acquire); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+#endif
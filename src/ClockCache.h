@@ -0,0 +1,148 @@
+#ifndef CLOCK_CACHE_H
+#define CLOCK_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include "LinearProbing.h"
+
+// Thread-safe int -> int cache with CLOCK (second-chance) eviction and a
+// lock-free get.
+//
+// LRUCache has to splice a list node on every hit, so readers need the same
+// exclusive lock as writers. Here a hit only sets a per-entry reference bit;
+// put() takes a mutex and, when full, sweeps a hand around the entries,
+// clearing set bits and evicting the first entry whose bit was already clear.
+// Recently read entries therefore survive one more sweep, which approximates
+// LRU at a fraction of the bookkeeping.
+//
+// Entries pack key and value into one 64-bit word so a reader always sees a
+// consistent pair. The key index is an open-addressing table of entry numbers
+// with linear probing and backward-shift deletion; writers keep it exact, and
+// a get that races with the eviction of a neighbouring key may report a
+// spurious miss (never a wrong value).
+class ClockCache {
+public:
+    explicit ClockCache(size_t cap) : max_entries(cap) {
+        if (cap == 0) throw std::invalid_argument("Capacity must be positive");
+        if (cap >= 0xffffffffu) throw std::invalid_argument("Capacity too large");
+        size_t buckets = 2;
+        while (buckets < cap * 2) buckets <<= 1;
+        mask = buckets - 1;
+        entries.reset(new Entry[cap]);
+        index.reset(new std::atomic<uint32_t>[buckets]);
+        for (size_t i = 0; i < buckets; ++i) index[i].store(empty, std::memory_order_relaxed);
+    }
+
+    ClockCache(const ClockCache&) = delete;
+    ClockCache& operator=(const ClockCache&) = delete;
+
+    // Lock-free. Returns -1 if the key is not cached.
+    int get(int key) const {
+        for (size_t b = home(key), probes = 0; probes <= mask; b = (b + 1) & mask, ++probes) {
+            uint32_t slot = index[b].load(std::memory_order_acquire);
+            if (slot == empty) return -1;
+            const Entry& e = entries[slot];
+            uint64_t word = e.word.load(std::memory_order_acquire);
+            if (key_of(word) != key) continue;
+            // Skip the store when already set so hot keys stay read-shared.
+            if (!e.referenced.load(std::memory_order_relaxed)) e.referenced.store(true, std::memory_order_relaxed);
+            return value_of(word);
+        }
+        return -1;
+    }
+
+    void put(int key, int value) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        size_t b = find(key);
+        uint32_t slot = index[b].load(std::memory_order_relaxed);
+        if (slot != empty) {
+            entries[slot].word.store(pack(key, value), std::memory_order_release);
+            entries[slot].referenced.store(true, std::memory_order_relaxed);
+            return;
+        }
+        size_t used = count.load(std::memory_order_relaxed);
+        if (used < max_entries) {
+            slot = static_cast<uint32_t>(used);
+            count.store(used + 1, std::memory_order_relaxed);
+        } else {
+            slot = evict();
+            b = find(key);   // the eviction may have shifted the probe run
+        }
+        entries[slot].referenced.store(false, std::memory_order_relaxed);
+        entries[slot].word.store(pack(key, value), std::memory_order_release);
+        index[b].store(slot, std::memory_order_release);
+    }
+
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+    size_t capacity() const { return max_entries; }
+
+private:
+    static constexpr uint32_t empty = 0xffffffffu;
+
+    struct Entry {
+        std::atomic<uint64_t> word{0};
+        mutable std::atomic<bool> referenced{false};
+    };
+
+    static uint64_t pack(int key, int value) {
+        return (uint64_t(static_cast<uint32_t>(key)) << 32) | static_cast<uint32_t>(value);
+    }
+    static int key_of(uint64_t word) { return static_cast<int>(static_cast<uint32_t>(word >> 32)); }
+    static int value_of(uint64_t word) { return static_cast<int>(static_cast<uint32_t>(word)); }
+
+    size_t home(int key) const {
+        return static_cast<size_t>((uint64_t(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+
+    // Bucket holding `key`, or the empty bucket ending its probe run.
+    // Writers only; the table is never full since it has 2x the capacity.
+    size_t find(int key) const {
+        size_t b = home(key);
+        for (;;) {
+            uint32_t slot = index[b].load(std::memory_order_relaxed);
+            if (slot == empty || key_of(entries[slot].word.load(std::memory_order_relaxed)) == key) return b;
+            b = (b + 1) & mask;
+        }
+    }
+
+    // Advances the hand past referenced entries (clearing their bit), then
+    // unindexes the first unreferenced one and returns its slot.
+    uint32_t evict() {
+        for (;;) {
+            Entry& e = entries[hand];
+            uint32_t slot = static_cast<uint32_t>(hand);
+            hand = hand + 1 == max_entries ? 0 : hand + 1;
+            if (e.referenced.load(std::memory_order_relaxed)) {
+                e.referenced.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            erase(find(key_of(e.word.load(std::memory_order_relaxed))));
+            return slot;
+        }
+    }
+
+    // Empties index bucket `hole`; see backward_shift_erase(). Runs under
+    // write_mutex, so only readers race with the moves.
+    void erase(size_t hole) {
+        auto slot_at = [this](size_t b) { return index[b].load(std::memory_order_relaxed); };
+        hole = backward_shift_erase(
+            hole, mask, [&](size_t b) { return slot_at(b) != empty; },
+            [&](size_t b) { return home(key_of(entries[slot_at(b)].word.load(std::memory_order_relaxed))); },
+            [&](size_t from, size_t to) { index[to].store(slot_at(from), std::memory_order_release); });
+        index[hole].store(empty, std::memory_order_release);
+    }
+
+    const size_t max_entries;
+    size_t mask;
+    std::unique_ptr<Entry[]> entries;
+    std::unique_ptr<std::atomic<uint32_t>[]> index;
+    std::atomic<size_t> count{0};
+    std::mutex write_mutex;
+    size_t hand = 0;
+};
+
+#endif
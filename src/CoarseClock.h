@@ -0,0 +1,66 @@
+#ifndef COARSE_CLOCK_H
+#define COARSE_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Monotonic nanosecond clock whose now() is a single relaxed load.
+//
+// A background thread re-reads std::chrono::steady_clock every `resolution`
+// and publishes the result; readers therefore lag real time by up to that
+// much and never pay for a clock_gettime. Good enough for cache TTLs, not for
+// timing short intervals.
+//
+// The thread is shared by the whole process and started by the first now()
+// call, not by construction, so a cache that holds a CoarseClock but never
+// sets a TTL never starts it. Once started it wakes every `resolution` until
+// static destruction at exit.
+class CoarseClock {
+public:
+    static constexpr std::chrono::milliseconds resolution{1};
+
+    int64_t now() const { return ticker().reading.load(std::memory_order_relaxed); }
+
+private:
+    struct Ticker {
+        Ticker() : reading(read()), thread([this] { run(); }) {}
+
+        ~Ticker() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            thread.join();
+        }
+
+        static int64_t read() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!wake.wait_for(lock, resolution, [this] { return stopping; }))
+                reading.store(read(), std::memory_order_relaxed);
+        }
+
+        std::atomic<int64_t> reading;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+        std::thread thread;
+    };
+
+    static Ticker& ticker() {
+        static Ticker instance;
+        return instance;
+    }
+};
+
+#endif
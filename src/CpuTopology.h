@@ -0,0 +1,125 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// CPUs grouped by NUMA node, read from /sys/devices/system/node. Machines
+// without that directory (or non-Linux builds) report a single node holding
+// every CPU the process may run on, so callers never need a special case.
+struct CpuTopology {
+    std::vector<std::vector<int>> nodes;   // CPU ids per node, ascending
+
+    size_t node_count() const { return nodes.size(); }
+
+    // Node owning `cpu`, or 0 if the CPU is unknown.
+    size_t node_of(int cpu) const {
+        for (size_t n = 0; n < nodes.size(); ++n)
+            if (std::find(nodes[n].begin(), nodes[n].end(), cpu) != nodes[n].end()) return n;
+        return 0;
+    }
+
+    // Every CPU, node by node.
+    std::vector<int> all_cpus() const {
+        std::vector<int> cpus;
+        for (const auto& node : nodes) cpus.insert(cpus.end(), node.begin(), node.end());
+        return cpus;
+    }
+
+    static const CpuTopology& instance() {
+        static const CpuTopology topology = detect();
+        return topology;
+    }
+
+    static CpuTopology detect() {
+        CpuTopology t;
+        const std::vector<int> allowed = allowed_cpus();
+#ifdef __linux__
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string list;
+        if (online && std::getline(online, list)) {
+            for (int node : parse_cpu_list(list)) {
+                std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                std::string cpus;
+                if (!in || !std::getline(in, cpus)) continue;
+                std::vector<int> usable;
+                for (int cpu : parse_cpu_list(cpus))
+                    if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) usable.push_back(cpu);
+                // Memory-only nodes and nodes outside our cpuset hold no workers.
+                if (!usable.empty()) t.nodes.push_back(std::move(usable));
+            }
+        }
+#endif
+        if (t.nodes.empty()) t.nodes.push_back(allowed);
+        return t;
+    }
+
+    // Parses the kernel's "0-3,8,10-11" format.
+    static std::vector<int> parse_cpu_list(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty() || range.find_first_not_of(" \n") == std::string::npos) continue;
+            size_t dash = range.find('-');
+            int lo = std::stoi(range.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+            for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+        }
+        return cpus;
+    }
+
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            for (int c = 0; c < CPU_SETSIZE; ++c)
+                if (CPU_ISSET(c, &set)) cpus.push_back(c);
+#endif
+        if (cpus.empty()) {
+            unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned c = 0; c < n; ++c) cpus.push_back(static_cast<int>(c));
+        }
+        return cpus;
+    }
+};
+
+// Restricts the calling thread to `cpus`. Returns false (leaving the thread
+// unpinned) when the set is empty, the platform has no affinity API, or the
+// call fails.
+inline bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+// CPU the calling thread is running on, or -1 if unknown.
+inline int current_cpu() {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+#endif
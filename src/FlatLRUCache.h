@@ -0,0 +1,338 @@
+#ifndef FLAT_LRUCACHE_H
+#define FLAT_LRUCACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "LRUCache.h"
+#include "LinearProbing.h"
+
+// LRU cache with all storage allocated up front.
+//
+// Entries live in one slab of `capacity` slots; the recency list is a pair of
+// 32-bit slot indices embedded in each slot, and the key index is an
+// open-addressing table (linear probing, backward-shift deletion) whose
+// buckets pack a 32-bit hash tag with a slot index, so most mismatches are
+// rejected without touching the slab. Once constructed, put() never
+// allocates: an eviction destroys the victim's key and value and builds the
+// new ones in the same slot. Keys and values that allocate themselves (e.g.
+// long strings) still do.
+//
+// Same interface as LRUCache, including heterogeneous lookup with
+// transparent Hash and KeyEqual.
+template<class K = int, class V = int, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+class FlatLRUCache {
+    template<class Q>
+    using is_lookup_key = cache_lookup_key<Q, K, Hash, KeyEqual>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    // Keys get_many() and put_many() prefetch ahead of resolving them.
+    static constexpr size_t batch_group = 16;
+
+    explicit FlatLRUCache(size_t cap, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+        : capacity_limit(cap), hash_fn(hash), equal_fn(equal) {
+        if (cap == 0) throw std::invalid_argument("Capacity must be positive");
+        if (cap > max_capacity) throw std::invalid_argument("Capacity too large");
+        // Load factor between 1/3 and 2/3 when full.
+        bucket_bits = 1;
+        while ((size_t(1) << bucket_bits) < cap + cap / 2) ++bucket_bits;
+        mask = (size_t(1) << bucket_bits) - 1;
+        slots.reset(new Slot[cap]);
+        index.reset(new uint64_t[mask + 1]);
+        for (size_t b = 0; b <= mask; ++b) index[b] = empty;
+    }
+
+    FlatLRUCache(const FlatLRUCache&) = delete;
+    FlatLRUCache& operator=(const FlatLRUCache&) = delete;
+
+    ~FlatLRUCache() {
+        for (uint32_t s = mru; s != nil; s = slots[s].next) destroy(s);
+    }
+
+    // Returns a copy of the value and marks the key most recently used, or
+    // cache_miss_value<V>() on a miss.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    V get(const Q& key) {
+        V* v = try_get(key);
+        return v ? *v : cache_miss_value<V>();
+    }
+
+    V get(const K& key) { return get<K>(key); }
+
+    // As LRUCache::try_get.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    V* try_get(const Q& key) { return try_get_tagged(key, tag_of(key)); }
+
+    V* try_get(const K& key) { return try_get<K>(key); }
+
+    // As LRUCache::get_many; the prefetches cover index buckets and then
+    // the slots they point to.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    size_t get_many(const Q* keys, size_t n, V* out) {
+        size_t hits = 0;
+        uint32_t tags[batch_group];
+        for (size_t base = 0; base < n; base += batch_group) {
+            const size_t m = std::min(batch_group, n - base);
+            prefetch_group(keys + base, m, tags);
+            for (size_t i = 0; i < m; ++i) {
+                if (V* v = try_get_tagged(keys[base + i], tags[i])) {
+                    out[base + i] = *v;
+                    ++hits;
+                } else {
+                    out[base + i] = cache_miss_value<V>();
+                }
+            }
+        }
+        return hits;
+    }
+
+    size_t get_many(const K* keys, size_t n, V* out) { return get_many<K>(keys, n, out); }
+
+    // As LRUCache::peek.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    const V* peek(const Q& key) const {
+        const uint32_t tag = tag_of(key);
+        size_t b = home(tag);
+        uint32_t s = probe(key, tag, b);
+        return s == nil ? nullptr : &slots[s].value();
+    }
+
+    const V* peek(const K& key) const { return peek<K>(key); }
+
+    // As LRUCache::get_or_compute: one probe finds either the entry or the
+    // bucket the new one goes into.
+    template<class KK, class F>
+    V& get_or_compute(KK&& key, F&& loader) {
+        if constexpr (!is_lookup_key<std::decay_t<KK>>::value) {
+            return get_or_compute(K(std::forward<KK>(key)), std::forward<F>(loader));
+        } else {
+            const uint32_t tag = tag_of(key);
+            size_t b = home(tag);
+            uint32_t s = probe(key, tag, b);
+            if (s != nil) {
+                touch(s);
+                return slots[s].value();
+            }
+            return insert(tag, b, std::forward<KK>(key), std::forward<F>(loader)());
+        }
+    }
+
+    template<class KK, class VV>
+    void put(KK&& key, VV&& value) {
+        emplace(std::forward<KK>(key), std::forward<VV>(value));
+    }
+
+    void put(const K& key, const V& value) { emplace(key, value); }
+
+    // As LRUCache::put_many.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    void put_many(const Q* keys, const V* values, size_t n) {
+        uint32_t tags[batch_group];
+        for (size_t base = 0; base < n; base += batch_group) {
+            const size_t m = std::min(batch_group, n - base);
+            prefetch_group(keys + base, m, tags);
+            for (size_t i = 0; i < m; ++i) store_tagged(tags[i], keys[base + i], values[base + i]);
+        }
+    }
+
+    void put_many(const K* keys, const V* values, size_t n) { put_many<K>(keys, values, n); }
+
+    // As LRUCache::emplace.
+    template<class KK, class... Args>
+    V& emplace(KK&& key, Args&&... args) {
+        if constexpr (!is_lookup_key<std::decay_t<KK>>::value) {
+            return emplace(K(std::forward<KK>(key)), std::forward<Args>(args)...);
+        } else {
+            const uint32_t tag = tag_of(key);
+            return store_tagged(tag, std::forward<KK>(key), std::forward<Args>(args)...);
+        }
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return capacity_limit; }
+
+private:
+    static constexpr uint32_t nil = 0xffffffffu;
+    static constexpr uint64_t empty = ~uint64_t(0);
+    static constexpr size_t max_capacity = size_t(1) << 30;
+
+    struct Slot {
+        uint32_t prev = nil;   // towards most recently used
+        uint32_t next = nil;   // towards least recently used; free list link
+        uint32_t tag = 0;
+        alignas(K) unsigned char key_storage[sizeof(K)];
+        alignas(V) unsigned char value_storage[sizeof(V)];
+
+        K& key() { return *std::launder(reinterpret_cast<K*>(key_storage)); }
+        V& value() { return *std::launder(reinterpret_cast<V*>(value_storage)); }
+        const K& key() const { return *std::launder(reinterpret_cast<const K*>(key_storage)); }
+        const V& value() const { return *std::launder(reinterpret_cast<const V*>(value_storage)); }
+    };
+
+    // Top 32 bits of the Fibonacci-mixed hash; the bucket is its top bits.
+    template<class Q>
+    uint32_t tag_of(const Q& key) const {
+        return static_cast<uint32_t>((static_cast<uint64_t>(hash_fn(key)) * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    size_t home(uint32_t tag) const { return tag >> (32 - bucket_bits); }
+
+    // Slot holding `key`, or nil with `b` left on the empty bucket that ends
+    // its probe run.
+    template<class Q>
+    uint32_t probe(const Q& key, uint32_t tag, size_t& b) const {
+        for (;; b = (b + 1) & mask) {
+            uint64_t e = index[b];
+            if (e == empty) return nil;
+            if (static_cast<uint32_t>(e >> 32) == tag) {
+                uint32_t s = static_cast<uint32_t>(e);
+                if (equal_fn(slots[s].key(), key)) return s;
+            }
+        }
+    }
+
+    template<class Q>
+    V* try_get_tagged(const Q& key, uint32_t tag) {
+        size_t b = home(tag);
+        uint32_t s = probe(key, tag, b);
+        if (s == nil) return nullptr;
+        touch(s);
+        return &slots[s].value();
+    }
+
+    // Body of emplace() for a lookup key whose tag is already known.
+    template<class KK, class... Args>
+    V& store_tagged(uint32_t tag, KK&& key, Args&&... args) {
+        size_t b = home(tag);
+        uint32_t s = probe(key, tag, b);
+        if (s != nil) {
+            V& v = slots[s].value();
+            if constexpr (sizeof...(Args) == 1 && (std::is_same<std::decay_t<Args>, V>::value && ...))
+                v = (std::forward<Args>(args), ...);
+            else
+                v = V(std::forward<Args>(args)...);
+            touch(s);
+            return v;
+        }
+        return insert(tag, b, std::forward<KK>(key), std::forward<Args>(args)...);
+    }
+
+    // Tags keys[0, m) into `tags` and prefetches their home buckets, then
+    // the slots those buckets point to.
+    template<class Q>
+    void prefetch_group(const Q* keys, size_t m, uint32_t* tags) const {
+        for (size_t i = 0; i < m; ++i) {
+            tags[i] = tag_of(keys[i]);
+            __builtin_prefetch(&index[home(tags[i])]);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            const uint64_t e = index[home(tags[i])];
+            if (e != empty) __builtin_prefetch(&slots[static_cast<uint32_t>(e)]);
+        }
+    }
+
+    // Adds a key known to be absent at bucket `b`, the end of its probe run,
+    // evicting the LRU entry when full.
+    template<class KK, class... Args>
+    V& insert(uint32_t tag, size_t b, KK&& key, Args&&... args) {
+        if (count == capacity_limit) {
+            evict_lru();
+            // The shift may have opened a hole earlier in this probe run.
+            for (b = home(tag); index[b] != empty; b = (b + 1) & mask) {}
+        }
+        const uint32_t s = free_head != nil ? free_head : static_cast<uint32_t>(fresh);
+        Slot& slot = slots[s];
+        ::new (static_cast<void*>(slot.key_storage)) K(std::forward<KK>(key));
+        try {
+            ::new (static_cast<void*>(slot.value_storage)) V(std::forward<Args>(args)...);
+        } catch (...) {
+            slot.key().~K();
+            throw;
+        }
+        if (s == free_head) free_head = slot.next;
+        else ++fresh;
+        slot.tag = tag;
+        index[b] = (uint64_t(tag) << 32) | s;
+        link_front(s);
+        ++count;
+        return slot.value();
+    }
+
+    void link_front(uint32_t s) {
+        slots[s].prev = nil;
+        slots[s].next = mru;
+        if (mru != nil) slots[mru].prev = s;
+        else lru = s;
+        mru = s;
+    }
+
+    void unlink(uint32_t s) {
+        Slot& slot = slots[s];
+        if (slot.prev != nil) slots[slot.prev].next = slot.next;
+        else mru = slot.next;
+        if (slot.next != nil) slots[slot.next].prev = slot.prev;
+        else lru = slot.prev;
+    }
+
+    void touch(uint32_t s) {
+        if (s == mru) return;
+        unlink(s);
+        link_front(s);
+    }
+
+    void destroy(uint32_t s) {
+        slots[s].key().~K();
+        slots[s].value().~V();
+    }
+
+    // Removes the least recently used entry from the list and the index and
+    // puts its slot on the free list.
+    void evict_lru() {
+        uint32_t s = lru;
+        unlink(s);
+        const uint64_t entry = (uint64_t(slots[s].tag) << 32) | s;
+        size_t b = home(slots[s].tag);
+        while (index[b] != entry) b = (b + 1) & mask;
+        erase_bucket(b);
+        destroy(s);
+        slots[s].next = free_head;
+        free_head = s;
+        --count;
+    }
+
+    // Empties index bucket `hole`; see backward_shift_erase().
+    void erase_bucket(size_t hole) {
+        hole = backward_shift_erase(
+            hole, mask, [this](size_t b) { return index[b] != empty; },
+            [this](size_t b) { return home(static_cast<uint32_t>(index[b] >> 32)); },
+            [this](size_t from, size_t to) { index[to] = index[from]; });
+        index[hole] = empty;
+    }
+
+    const size_t capacity_limit;
+    Hash hash_fn;
+    KeyEqual equal_fn;
+    unsigned bucket_bits;
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    std::unique_ptr<uint64_t[]> index;
+    uint32_t mru = nil;
+    uint32_t lru = nil;
+    uint32_t free_head = nil;
+    size_t fresh = 0;   // slots [fresh, capacity) have never been used
+    size_t count = 0;
+};
+
+#endif
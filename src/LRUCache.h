@@ -1,48 +1,724 @@
 #ifndef LRUCACHE_H
 #define LRUCACHE_H
 
-#include <list>
-#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "CachePolicy.h"
+#include "CoarseClock.h"
 
+// Opt-in for heterogeneous lookup: the functor declares `is_transparent`.
+template<class T, class = void>
+struct is_transparent_functor : std::false_type {};
+template<class T>
+struct is_transparent_functor<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+// Whether a Q can be hashed and compared against K keys directly.
+template<class Q, class K, class Hash, class KeyEqual>
+struct cache_lookup_key
+    : std::bool_constant<std::is_same<Q, K>::value ||
+                         (is_transparent_functor<Hash>::value && is_transparent_functor<KeyEqual>::value)> {};
+
+// Value the caches' get() returns on a miss: -1 for signed arithmetic types,
+// as the original int API did, and a value-initialized V otherwise.
+template<class V>
+V cache_miss_value() {
+    if constexpr (std::is_arithmetic<V>::value && std::is_signed<V>::value) return V(-1);
+    else return V();
+}
+
+// Weigher that counts every entry as 1, making the capacity an entry count.
+struct UnitWeigher {
+    template<class K, class V>
+    size_t operator()(const K&, const V&) const { return 1; }
+};
+
+// Clock argument for caches whose entries never expire: nodes carry no
+// deadline and lookups never read a clock.
+struct NoExpiry {};
+
+// Least-recently-used cache over arbitrary keys and values.
+//
+// Each entry is one node, allocated through `Allocator`, that sits both on the
+// recency list and on its hash bucket's chain, so a key is stored once and a
+// hit costs one probe plus a few pointer swaps. The bucket array grows with
+// the number of entries rather than the capacity.
+//
+// Which entry to evict is up to `Policy` (see CachePolicy.h): LruPolicy by
+// default, or TinyLfuPolicy for frequency-based admission that survives
+// scans. The policy owns the recency list; "most recently used" below means
+// whatever the policy makes of a hit.
+//
+// With a `Weigher` other than UnitWeigher the capacity is a budget in
+// whatever unit weigher(key, value) returns (typically bytes): each entry's
+// weight is computed once when it is stored and kept in its node, and
+// inserting evicts until the total fits. An entry heavier than the whole
+// capacity is rejected with std::invalid_argument. See WeightedLRUCache.
+//
+// With a `Clock` other than NoExpiry (anything with an `int64_t now() const`
+// in nanoseconds, normally CoarseClock) entries can expire: each node keeps
+// a deadline set when it is stored or overwritten, from put()'s TTL argument
+// or the default TTL. Expiry is lazy. A lookup that finds an expired entry
+// removes it and reports a miss, and every write also checks the next
+// couple of buckets in a sweep that cycles through the table, so dead
+// entries nobody asks for stop holding capacity without a timer thread.
+// purge_expired() sweeps further on demand. While no entry has a finite
+// deadline the sweep is skipped and nothing reads the clock, so an expiring
+// cache used without TTLs costs little more than a plain one. See
+// ExpiringLRUCache.
+//
+// When both Hash and KeyEqual declare `is_transparent`, lookups accept any
+// type they can hash and compare (e.g. std::string_view against std::string
+// keys) without building a key; see StringLRUCache. Template arguments
+// default to int -> int, so `LRUCache cache(n)` still names the original
+// cache, also spelled IntLRUCache.
+template<class K = int, class V = int, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>,
+         class Allocator = std::allocator<std::pair<const K, V>>, class Policy = LruPolicy,
+         class Weigher = UnitWeigher, class Clock = NoExpiry>
 class LRUCache {
-private:
-    size_t capacity;
-    std::list<int> lru_list;
-    std::unordered_map<int, std::pair<int, std::list<int>::iterator>> cache;
+    // Key types usable for lookup without converting to K first.
+    template<class Q>
+    using is_lookup_key = cache_lookup_key<Q, K, Hash, KeyEqual>;
+
+    static constexpr bool weighted = !std::is_same<Weigher, UnitWeigher>::value;
+    static constexpr bool expiring = !std::is_same<Clock, NoExpiry>::value;
 
 public:
-    LRUCache(size_t cap) : capacity(cap) {
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using policy_type = Policy;
+    using weigher_type = Weigher;
+    using clock_type = Clock;
+
+    // TTL meaning "never expires", the initial default.
+    static constexpr std::chrono::nanoseconds forever = std::chrono::nanoseconds::max();
+
+    // Buckets the incremental expiry sweep checks per write.
+    static constexpr size_t sweep_buckets = 2;
+
+    // Keys get_many() and put_many() prefetch ahead of resolving them.
+    static constexpr size_t batch_group = 16;
+
+    explicit LRUCache(size_t cap, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                      const Allocator& alloc = Allocator(), const Weigher& weigher = Weigher(),
+                      const Clock& clock = Clock())
+        : capacity_limit(cap), hash_fn(hash), equal_fn(equal), weigh(weigher), clock(clock), node_alloc(alloc),
+          buckets(BucketAlloc(alloc)), policy(cap) {
         if (cap == 0) throw std::invalid_argument("Capacity must be positive");
+        buckets.assign(size_t(1) << bucket_bits, nullptr);
+    }
+
+    // Copies entries and their place in the policy's order.
+    LRUCache(const LRUCache& other)
+        : LRUCache(other.capacity_limit, other.hash_fn, other.equal_fn,
+                   std::allocator_traits<NodeAlloc>::select_on_container_copy_construction(other.node_alloc),
+                   other.weigh, other.clock) {
+        policy = Policy(other.policy);
+        ttl = other.ttl;
+        other.policy.for_each([this](CacheHook* h) {
+            const Node& src = static_cast<const Node&>(*h);
+            Node* n = NodeTraits::allocate(node_alloc, 1);
+            try {
+                NodeTraits::construct(node_alloc, n, src.hash, std::forward_as_tuple(src.key),
+                                      std::forward_as_tuple(src.value));
+            } catch (...) {
+                NodeTraits::deallocate(node_alloc, n, 1);
+                throw;
+            }
+            n->segment = src.segment;
+            n->weight = src.weight;
+            if constexpr (expiring) set_deadline(n, src.expires_at);
+            total_weight += src.weight;
+            policy.restore(n);
+            link_bucket(n);
+            if (++count > buckets.size()) grow();
+        });
+    }
+
+    LRUCache(LRUCache&& other)
+        : LRUCache(other.capacity_limit, other.hash_fn, other.equal_fn, other.node_alloc, other.weigh,
+                   other.clock) {
+        swap(other);
+    }
+
+    LRUCache& operator=(LRUCache other) {
+        swap(other);
+        return *this;
+    }
+
+    ~LRUCache() { destroy_nodes(); }
+
+    void swap(LRUCache& other) {
+        using std::swap;
+        swap(capacity_limit, other.capacity_limit);
+        swap(hash_fn, other.hash_fn);
+        swap(equal_fn, other.equal_fn);
+        swap(weigh, other.weigh);
+        swap(clock, other.clock);
+        swap(ttl, other.ttl);
+        swap(node_alloc, other.node_alloc);
+        buckets.swap(other.buckets);
+        swap(bucket_bits, other.bucket_bits);
+        swap(policy, other.policy);
+        swap(count, other.count);
+        swap(total_weight, other.total_weight);
+        swap(sweep_cursor, other.sweep_cursor);
+        swap(timed_count, other.timed_count);
+    }
+
+    // Returns a copy of the value and marks the key most recently used, or
+    // cache_miss_value<V>() on a miss.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    V get(const Q& key) {
+        V* v = try_get(key);
+        return v ? *v : cache_miss_value<V>();
+    }
+
+    V get(const K& key) { return get<K>(key); }
+
+    // Pointer to the cached value, marking the key most recently used, or
+    // nullptr on a miss. Valid until the entry is evicted.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    V* try_get(const Q& key) { return try_get_hashed(key, hash_fn(key)); }
+
+    V* try_get(const K& key) { return try_get<K>(key); }
+
+    // Batch get: out[i] becomes get(keys[i]), in order, and the number of
+    // hits is returned. Keys are taken `batch_group` at a time: all of them
+    // are hashed and their buckets prefetched, then the bucket heads are
+    // prefetched, and only then is each one resolved, so a batch of cold
+    // lookups waits on memory a group at a time instead of a key at a time.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    size_t get_many(const Q* keys, size_t n, V* out) {
+        size_t hits = 0;
+        size_t hashes[batch_group];
+        for (size_t base = 0; base < n; base += batch_group) {
+            const size_t m = std::min(batch_group, n - base);
+            prefetch_group(keys + base, m, hashes);
+            for (size_t i = 0; i < m; ++i) {
+                if (V* v = try_get_hashed(keys[base + i], hashes[i])) {
+                    out[base + i] = *v;
+                    ++hits;
+                } else {
+                    out[base + i] = cache_miss_value<V>();
+                }
+            }
+        }
+        return hits;
+    }
+
+    size_t get_many(const K* keys, size_t n, V* out) { return get_many<K>(keys, n, out); }
+
+    // As try_get, but leaves the recency order untouched.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    const V* peek(const Q& key) const {
+        const Node* n = find(key, hash_fn(key));
+        return n && !expired(n) ? &n->value : nullptr;
+    }
+
+    const V* peek(const K& key) const { return peek<K>(key); }
+
+    // The cached value for `key`; on a miss, the result of loader() is
+    // inserted and returned. Hashes and walks the bucket once either way,
+    // unlike get() followed by put(). The loader must not use this cache; if
+    // it throws, the cache is unchanged.
+    template<class KK, class F>
+    V& get_or_compute(KK&& key, F&& loader) {
+        if constexpr (!is_lookup_key<std::decay_t<KK>>::value) {
+            return get_or_compute(K(std::forward<KK>(key)), std::forward<F>(loader));
+        } else {
+            const size_t h = hash_fn(key);
+            if (Node* n = find_live(key, h)) {
+                policy.on_hit(n);
+                return n->value;
+            }
+            auto&& value = std::forward<F>(loader)();
+            policy.on_miss(h);   // only once loaded, so a throw leaves the policy alone too
+            if constexpr (expiring) purge_expired(sweep_buckets);
+            return insert(h, deadline_after(ttl), std::forward<KK>(key), std::forward<decltype(value)>(value));
+        }
     }
 
-    int get(int key) {
-        auto it = cache.find(key);
-        if (it == cache.end()) return -1;
-        lru_list.erase(it->second.second);
-        lru_list.push_front(key);
-        it->second.second = lru_list.begin();
-        return it->second.first;
+    // Inserts or overwrites, forwarding key and value into the cache.
+    template<class KK, class VV>
+    void put(KK&& key, VV&& value) {
+        emplace(std::forward<KK>(key), std::forward<VV>(value));
     }
 
-    void put(int key, int value) {
-        auto it = cache.find(key);
-        if (it != cache.end()) {
-            lru_list.erase(it->second.second);
-            lru_list.push_front(key);
-            cache[key] = {value, lru_list.begin()};
-            return;
+    void put(const K& key, const V& value) { emplace(key, value); }
+
+    // Batch put: put(keys[i], values[i]) for each i in order, with the same
+    // group-wise prefetching as get_many().
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    void put_many(const Q* keys, const V* values, size_t n) {
+        size_t hashes[batch_group];
+        for (size_t base = 0; base < n; base += batch_group) {
+            const size_t m = std::min(batch_group, n - base);
+            prefetch_group(keys + base, m, hashes);
+            for (size_t i = 0; i < m; ++i)
+                store_hashed(hashes[i], deadline_after(ttl), keys[base + i], values[base + i]);
         }
-        if (cache.size() >= capacity) {
-            int lru_key = lru_list.back();
-            lru_list.pop_back();
-            cache.erase(lru_key);
+    }
+
+    void put_many(const K* keys, const V* values, size_t n) { put_many<K>(keys, values, n); }
+
+    // As put(), but the entry expires `entry_ttl` from now instead of after
+    // the default TTL. Expiring caches only.
+    template<class KK, class VV>
+    void put(KK&& key, VV&& value, std::chrono::nanoseconds entry_ttl) {
+        static_assert(expiring, "TTLs need a Clock other than NoExpiry");
+        check_ttl(entry_ttl);
+        store(deadline_after(entry_ttl), std::forward<KK>(key), std::forward<VV>(value));
+    }
+
+    // Constructs the value in place from `args` (assigning over the old value
+    // if the key is present) and marks the key most recently used. A new key
+    // is built from `key` only when it is not already cached.
+    template<class KK, class... Args>
+    V& emplace(KK&& key, Args&&... args) {
+        return store(deadline_after(ttl), std::forward<KK>(key), std::forward<Args>(args)...);
+    }
+
+    // Removes the key; false if it was not cached.
+    template<class Q, class = std::enable_if_t<is_lookup_key<Q>::value>>
+    bool erase(const Q& key) {
+        Node* n = find(key, hash_fn(key));
+        if (!n) return false;
+        const bool live = !expired(n);
+        erase_node(n);
+        return live;
+    }
+
+    bool erase(const K& key) { return erase<K>(key); }
+
+    // TTL for entries stored without one; `forever` unless set. Entries
+    // already cached keep their deadline. Expiring caches only.
+    void set_default_ttl(std::chrono::nanoseconds default_ttl) {
+        static_assert(expiring, "TTLs need a Clock other than NoExpiry");
+        check_ttl(default_ttl);
+        ttl = default_ttl;
+    }
+
+    std::chrono::nanoseconds default_ttl() const { return ttl; }
+
+    // Continues the incremental sweep over up to `max_buckets` buckets
+    // (all of them by default), removing expired entries. Returns how many
+    // were removed. For callers that want dead entries gone sooner than
+    // writes alone would, e.g. from a periodic timer.
+    size_t purge_expired(size_t max_buckets = std::numeric_limits<size_t>::max()) {
+        if constexpr (!expiring) {
+            return 0;
+        } else {
+            if (timed_count == 0) return 0;
+            const int64_t now = clock.now();
+            size_t removed = 0;
+            for (size_t i = 0, end = std::min(max_buckets, buckets.size()); i < end; ++i) {
+                Node** p = &buckets[sweep_cursor];
+                while (Node* n = *p) {
+                    if (now < n->expires_at) {
+                        p = &n->chain;
+                        continue;
+                    }
+                    *p = n->chain;
+                    drop(n);
+                    ++removed;
+                }
+                sweep_cursor = (sweep_cursor + 1) & (buckets.size() - 1);
+            }
+            return removed;
         }
-        lru_list.push_front(key);
-        cache[key] = {value, lru_list.begin()};
     }
-    
-    size_t size() const { return cache.size(); }
+
+    // Calls fn(key, value) for each entry, coldest first in the policy's
+    // order (least recently used first under LruPolicy), changing nothing.
+    // Expired entries not yet removed are skipped.
+    template<class F>
+    void for_each(F&& fn) const {
+        policy.for_each([&](const CacheHook* h) {
+            const Node& n = static_cast<const Node&>(*h);
+            if (!expired(&n)) fn(n.key, n.value);
+        });
+    }
+
+    // Sizes the bucket array for `n` entries (at most the capacity) in one
+    // step, so filling the cache does not rehash repeatedly on the way.
+    void reserve(size_t n) {
+        n = std::min(n, capacity_limit);
+        unsigned bits = bucket_bits;
+        while ((size_t(1) << bits) < n) ++bits;
+        if (bits != bucket_bits) rehash(bits);
+    }
+
+    // As in the std unordered containers: the number of buckets and the
+    // bucket `key` belongs in.
+    size_t bucket_count() const { return buckets.size(); }
+    size_t bucket(const K& key) const { return bucket_of(hash_fn(key)); }
+
+    // Includes expired entries not yet removed.
+    size_t size() const { return count; }
+    size_t capacity() const { return capacity_limit; }
+
+    // Sum of the entries' weights; size() when unweighted.
+    size_t weight() const { return weighted ? total_weight : count; }
+
+    // Whether put(key, value) would take the entry rather than throw for
+    // outweighing the whole capacity. Always true when unweighted.
+    bool fits(const K& key, const V& value) const {
+        if constexpr (weighted) return weight_fits(weigh(key, value));
+        else return true;
+    }
+
+private:
+    static constexpr int64_t never = std::numeric_limits<int64_t>::max();
+
+    struct NoDeadline {};
+    struct Deadline {
+        int64_t expires_at = never;   // Clock::now() value at which the entry dies
+    };
+
+    struct Node : CacheHook, std::conditional_t<expiring, Deadline, NoDeadline> {
+        template<class KT, class VT>
+        Node(size_t h, KT&& k, VT&& v)
+            : key(std::make_from_tuple<K>(std::forward<KT>(k))), value(std::make_from_tuple<V>(std::forward<VT>(v))) {
+            hash = h;
+        }
+
+        Node* chain = nullptr;   // next node in the same bucket
+        K key;
+        V value;
+    };
+
+    using NodeAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+    using BucketAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Node*>;
+
+    // A single V argument is assigned directly; anything else builds a V first.
+    template<class... Args>
+    static void assign(V& target, Args&&... args) {
+        if constexpr (sizeof...(Args) == 1 && (std::is_same<std::decay_t<Args>, V>::value && ...))
+            target = (std::forward<Args>(args), ...);
+        else
+            target = V(std::forward<Args>(args)...);
+    }
+
+    // Fibonacci hashing on top of Hash, whose output (std::hash<int> is the
+    // identity) need not be well mixed in the low bits.
+    size_t bucket_of(size_t h) const {
+        return static_cast<size_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> (64 - bucket_bits));
+    }
+
+    static void check_ttl(std::chrono::nanoseconds t) {
+        if (t <= std::chrono::nanoseconds::zero()) throw std::invalid_argument("TTL must be positive");
+    }
+
+    // Clock reading at which an entry stored now with TTL `t` expires.
+    int64_t deadline_after(std::chrono::nanoseconds t) const {
+        if constexpr (!expiring) {
+            return never;
+        } else {
+            if (t == forever) return never;
+            const int64_t now = clock.now();
+            return t.count() < never - now ? now + t.count() : never;
+        }
+    }
+
+    bool expired(const Node* n) const {
+        if constexpr (expiring) return n->expires_at != never && clock.now() >= n->expires_at;
+        else return false;
+    }
+
+    // Sets n's deadline, keeping timed_count in step. A freshly built node
+    // starts out at `never`.
+    void set_deadline(Node* n, int64_t deadline) {
+        if constexpr (expiring) {
+            if (n->expires_at != never) --timed_count;
+            if (deadline != never) ++timed_count;
+            n->expires_at = deadline;
+        }
+    }
+
+    // For every node leaving the cache.
+    void forget_deadline(const Node* n) {
+        if constexpr (expiring) timed_count -= n->expires_at != never;
+    }
+
+    // find(), except that an expired match is removed and reported missing.
+    template<class Q>
+    Node* find_live(const Q& key, size_t h) {
+        Node* n = find(key, h);
+        if (n && expired(n)) {
+            erase_node(n);
+            return nullptr;
+        }
+        return n;
+    }
+
+    template<class Q>
+    V* try_get_hashed(const Q& key, size_t h) {
+        Node* n = find_live(key, h);
+        if (!n) {
+            policy.on_miss(h);
+            return nullptr;
+        }
+        policy.on_hit(n);
+        return &n->value;
+    }
+
+    // Hashes keys[0, m) into `hashes` and prefetches, first the buckets and
+    // then the nodes at their heads (hook and key, which may straddle cache
+    // lines). Prefetches are hints, so stale heads are harmless.
+    template<class Q>
+    void prefetch_group(const Q* keys, size_t m, size_t* hashes) const {
+        for (size_t i = 0; i < m; ++i) {
+            hashes[i] = hash_fn(keys[i]);
+            __builtin_prefetch(&buckets[bucket_of(hashes[i])]);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            if (const Node* head = buckets[bucket_of(hashes[i])]) {
+                __builtin_prefetch(head);
+                __builtin_prefetch(&head->key);
+            }
+        }
+    }
+
+    // Body of emplace() and put(), with the deadline for the stored entry.
+    template<class KK, class... Args>
+    V& store(int64_t deadline, KK&& key, Args&&... args) {
+        if constexpr (!is_lookup_key<std::decay_t<KK>>::value) {
+            return store(deadline, K(std::forward<KK>(key)), std::forward<Args>(args)...);
+        } else {
+            return store_hashed(hash_fn(key), deadline, std::forward<KK>(key), std::forward<Args>(args)...);
+        }
+    }
+
+    // store() for a lookup key whose hash is already known. The sweep runs
+    // before the lookup: a short enough TTL can already have lapsed by the
+    // time the entry is re-deadlined, and a later sweep would free it.
+    template<class KK, class... Args>
+    V& store_hashed(size_t h, int64_t deadline, KK&& key, Args&&... args) {
+        if constexpr (expiring) purge_expired(sweep_buckets);
+        if (Node* n = find_live(key, h)) {
+            assign(n->value, std::forward<Args>(args)...);
+            if constexpr (weighted) reweigh(n);
+            set_deadline(n, deadline);
+            policy.on_hit(n);
+            return n->value;
+        }
+        policy.on_miss(h);
+        return insert(h, deadline, std::forward<KK>(key), std::forward<Args>(args)...);
+    }
+
+    // Adds a key known to be absent, evicting when full. Weighted entries are
+    // built (and weighed) before anything is evicted for them. On expiring
+    // caches the caller has already advanced the sweep, so an expired entry
+    // can make the room instead of a live one.
+    template<class KK, class... Args>
+    V& insert(size_t h, int64_t deadline, KK&& key, Args&&... args) {
+        Node* n = !weighted && count >= capacity_limit ? recycle_victim() : NodeTraits::allocate(node_alloc, 1);
+        try {
+            NodeTraits::construct(node_alloc, n, h, std::forward_as_tuple(std::forward<KK>(key)),
+                                  std::forward_as_tuple(std::forward<Args>(args)...));
+        } catch (...) {
+            NodeTraits::deallocate(node_alloc, n, 1);
+            throw;
+        }
+        if constexpr (weighted) {
+            try {
+                n->weight = checked_weight(n->key, n->value);
+            } catch (...) {
+                NodeTraits::destroy(node_alloc, n);
+                NodeTraits::deallocate(node_alloc, n, 1);
+                throw;
+            }
+            evict_until_fits(n->weight);
+            total_weight += n->weight;
+        }
+        set_deadline(n, deadline);
+        policy.on_insert(n);
+        link_bucket(n);
+        ++count;
+        if (count > buckets.size()) grow();
+        return n->value;
+    }
+
+    template<class Q>
+    Node* find(const Q& key, size_t h) const {
+        for (Node* n = buckets[bucket_of(h)]; n; n = n->chain)
+            if (n->hash == h && equal_fn(n->key, key)) return n;
+        return nullptr;
+    }
+
+    void link_bucket(Node* n) {
+        Node*& head = buckets[bucket_of(n->hash)];
+        n->chain = head;
+        head = n;
+    }
+
+    void unlink_bucket(Node* n) {
+        Node** p = &buckets[bucket_of(n->hash)];
+        while (*p != n) p = &(*p)->chain;
+        *p = n->chain;
+    }
+
+    // Removes an entry the cache itself decided to drop (expired or erased).
+    void erase_node(Node* n) {
+        unlink_bucket(n);
+        drop(n);
+    }
+
+    // Second half of erase_node, for callers that already unlinked n from
+    // its bucket.
+    void drop(Node* n) {
+        policy.on_erase(n);
+        forget_deadline(n);
+        if constexpr (weighted) total_weight -= n->weight;
+        --count;
+        NodeTraits::destroy(node_alloc, n);
+        NodeTraits::deallocate(node_alloc, n, 1);
+    }
+
+    // Evicts the policy's victim and hands back its storage for the incoming
+    // entry, saving an allocation round trip.
+    Node* recycle_victim() {
+        Node* n = static_cast<Node*>(policy.evict());
+        unlink_bucket(n);
+        forget_deadline(n);
+        NodeTraits::destroy(node_alloc, n);
+        --count;
+        return n;
+    }
+
+    bool weight_fits(size_t w) const { return w <= capacity_limit && w <= 0xffffffffu; }
+
+    uint32_t checked_weight(const K& key, const V& value) const {
+        const size_t w = weigh(key, value);
+        if (!weight_fits(w)) throw std::invalid_argument("Entry outweighs the cache capacity");
+        return static_cast<uint32_t>(w);
+    }
+
+    // Evicts until `incoming` more weight fits. O(1) per eviction.
+    void evict_until_fits(size_t incoming) {
+        while (count > 0 && total_weight + incoming > capacity_limit) {
+            Node* victim = static_cast<Node*>(policy.evict());
+            unlink_bucket(victim);
+            forget_deadline(victim);
+            total_weight -= victim->weight;
+            --count;
+            NodeTraits::destroy(node_alloc, victim);
+            NodeTraits::deallocate(node_alloc, victim, 1);
+        }
+    }
+
+    // After an overwrite: account for the new weight, evicting other entries
+    // if it grew. An overweight value removes the entry and throws.
+    void reweigh(Node* n) {
+        policy.on_erase(n);
+        total_weight -= n->weight;
+        uint32_t w;
+        try {
+            w = checked_weight(n->key, n->value);
+        } catch (...) {
+            unlink_bucket(n);
+            forget_deadline(n);
+            --count;
+            NodeTraits::destroy(node_alloc, n);
+            NodeTraits::deallocate(node_alloc, n, 1);
+            throw;
+        }
+        --count;   // not a candidate while making room for itself
+        evict_until_fits(w);
+        ++count;
+        n->weight = w;
+        total_weight += w;
+        policy.restore(n);
+    }
+
+    void grow() { rehash(bucket_bits + 1); }
+
+    // Relinks every node into 2^bits buckets; never shrinks.
+    void rehash(unsigned bits) {
+        std::vector<Node*, BucketAlloc> old(size_t(1) << bits, nullptr, buckets.get_allocator());
+        old.swap(buckets);
+        bucket_bits = bits;
+        for (Node* head : old) {
+            while (head) {
+                Node* next = head->chain;
+                link_bucket(head);
+                head = next;
+            }
+        }
+    }
+
+    // Frees every node; the policy's lists are left dangling, so only for
+    // the destructor.
+    void destroy_nodes() {
+        for (Node*& head : buckets) {
+            while (head) {
+                Node* next = head->chain;
+                NodeTraits::destroy(node_alloc, head);
+                NodeTraits::deallocate(node_alloc, head, 1);
+                head = next;
+            }
+        }
+        count = 0;
+        timed_count = 0;
+    }
+
+    size_t capacity_limit;
+    Hash hash_fn;
+    KeyEqual equal_fn;
+    Weigher weigh;
+    Clock clock;
+    std::chrono::nanoseconds ttl = forever;
+    NodeAlloc node_alloc;
+    std::vector<Node*, BucketAlloc> buckets;
+    unsigned bucket_bits = 3;
+    Policy policy;
+    size_t count = 0;
+    size_t total_weight = 0;   // weighted caches only
+    size_t sweep_cursor = 0;   // next bucket for the expiry sweep
+    size_t timed_count = 0;    // entries whose deadline is not `never`
 };
 
+using IntLRUCache = LRUCache<int, int>;
+
+// Transparent hash for std::string keys: hashes anything convertible to
+// std::string_view, so string_view and C string lookups build no temporary.
+struct TransparentStringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+};
+
+template<class V>
+using StringLRUCache = LRUCache<std::string, V, TransparentStringHash, std::equal_to<>>;
+
+// LRUCache whose capacity is a budget of weigher(key, value) units.
+template<class K, class V, class Weigher, class Policy = LruPolicy, class Hash = std::hash<K>,
+         class KeyEqual = std::equal_to<K>>
+using WeightedLRUCache = LRUCache<K, V, Hash, KeyEqual, std::allocator<std::pair<const K, V>>, Policy, Weigher>;
+
+// LRUCache with W-TinyLFU admission instead of pure LRU eviction.
+template<class K, class V, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+using TinyLfuCache = LRUCache<K, V, Hash, KeyEqual, std::allocator<std::pair<const K, V>>, TinyLfuPolicy>;
+
+
+// LRUCache whose entries expire after a TTL, read from `Clock`.
+template<class K, class V, class Clock = CoarseClock, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+using ExpiringLRUCache = LRUCache<K, V, Hash, KeyEqual, std::allocator<std::pair<const K, V>>, LruPolicy,
+                                  UnitWeigher, Clock>;
+
 #endif
@@ -0,0 +1,27 @@
+#ifndef LINEAR_PROBING_H
+#define LINEAR_PROBING_H
+
+#include <cstddef>
+
+// Deletion for open-addressing tables with linear probing over `mask + 1`
+// buckets (FlatLRUCache's key index and ClockCache's).
+//
+// Vacates bucket `hole` without leaving a tombstone: walks the rest of its
+// probe run and moves each member whose home bucket is not in the cyclic
+// range (hole, b] back into the hole, which then moves to where that member
+// was. Lookups can keep stopping at the first empty bucket. The table is
+// described by three callables: occupied(b), home_of(b) for an occupied b,
+// and move(from, to). Returns the bucket left vacant, for the caller to
+// mark empty.
+template<class Occupied, class HomeOf, class Move>
+size_t backward_shift_erase(size_t hole, size_t mask, Occupied occupied, HomeOf home_of, Move move) {
+    for (size_t b = (hole + 1) & mask; occupied(b); b = (b + 1) & mask) {
+        if (((b - home_of(b)) & mask) >= ((b - hole) & mask)) {
+            move(b, hole);
+            hole = b;
+        }
+    }
+    return hole;
+}
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef LOADING_CACHE_H
+#define LOADING_CACHE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include "LRUCache.h"
+#include "PoolFuture.h"
+
+// Read-through cache that loads missing values on a SimpleThreadPool and
+// coalesces concurrent misses.
+//
+// get_async(key) returns a PoolFuture that is already ready on a hit and is
+// otherwise the future of the load for that key, started if none is in
+// flight. However many callers miss on a key at once, the loader runs once
+// and every one of them receives its value (or its exception). A value that
+// loads is stored in the cache; a failure is not, so the next miss retries.
+// put() and invalidate() detach a load in flight for their key: callers
+// already waiting still get its result, but it is not stored, and the next
+// miss starts a fresh load.
+//
+// `Cache` is the underlying LRUCache flavour; ExpiringLRUCache gives loaded
+// values a TTL. It is guarded by one mutex that is held for lookups and
+// bookkeeping, never while loading. The loader runs on pool workers, so it
+// must not block on this cache's get(). The pool must outlive the cache,
+// whose destructor waits for loads still running.
+template<class K, class V, class Cache = LRUCache<K, V>>
+class LoadingCache {
+public:
+    using Loader = std::function<V(const K&)>;
+
+    LoadingCache(SimpleThreadPool& pool, size_t capacity, Loader loader)
+        : LoadingCache(pool, Cache(capacity), std::move(loader)) {}
+
+    LoadingCache(SimpleThreadPool& pool, Cache cache, Loader loader)
+        : pool(pool), cache(std::move(cache)), loader(std::move(loader)) {
+        if (!this->loader) throw std::invalid_argument("LoadingCache needs a loader");
+    }
+
+    LoadingCache(const LoadingCache&) = delete;
+    LoadingCache& operator=(const LoadingCache&) = delete;
+
+    ~LoadingCache() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return running == 0; });
+    }
+
+    // Future for the value of `key`; see above. Safe to call, and to attach
+    // then() continuations to, from pool workers.
+    PoolFuture<V> get_async(const K& key) {
+        std::optional<V> hit;
+        PoolFuture<V> pending;
+        uint64_t launch_id = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (V* v = cache.try_get(key)) hit.emplace(*v);
+            else pending = join_or_register(key, launch_id);
+        }
+        if (hit) {
+            auto state = std::make_shared<PoolFutureState<V>>(pool);
+            state->set_value(std::move(*hit));
+            return PoolFuture<V>(state);
+        }
+        if (launch_id) launch(key, pending.shared_state(), launch_id);
+        return pending;
+    }
+
+    // Blocking get: the cached value, or the result of the (possibly shared)
+    // load, whose exception is rethrown here. For threads outside the pool.
+    V get(const K& key) {
+        PoolFuture<V> pending;
+        uint64_t launch_id = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (V* v = cache.try_get(key)) return *v;
+            pending = join_or_register(key, launch_id);
+        }
+        if (launch_id) launch(key, pending.shared_state(), launch_id);
+        return pending.get();
+    }
+
+    // The cached value, without loading on a miss.
+    std::optional<V> get_if_present(const K& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (V* v = cache.try_get(key)) return *v;
+        return std::nullopt;
+    }
+
+    // Stores a value directly, overriding any load in flight for the key.
+    void put(const K& key, V value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.put(key, std::move(value));
+        loads.erase(key);
+    }
+
+    // Drops the cached value and detaches any load in flight for the key.
+    void invalidate(const K& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.erase(key);
+        loads.erase(key);
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cache.size();
+    }
+
+    // Keys with a load in flight that will be stored when it completes.
+    size_t loads_in_flight() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return loads.size();
+    }
+
+private:
+    using State = PoolFutureState<V>;
+
+    struct Load {
+        std::shared_ptr<State> state;
+        uint64_t id;   // tells a detached load's completion from its successor's
+    };
+
+    // Pool task for one load. Should the pool discard it unrun, the waiters
+    // get broken_promise and the load is unregistered all the same.
+    struct LoadTask {
+        LoadTask(LoadingCache* o, K k, std::shared_ptr<State> s, uint64_t i)
+            : owner(o), key(std::move(k)), state(std::move(s)), id(i) {}
+        LoadTask(LoadTask&&) = default;
+
+        ~LoadTask() {
+            if (!state) return;
+            state->abandon();
+            owner->finish(key, id, nullptr);
+        }
+
+        void operator()() { owner->load(key, std::move(state), id); }
+
+        LoadingCache* owner;
+        K key;
+        std::shared_ptr<State> state;
+        uint64_t id;
+    };
+
+    // Under the lock, after a miss: the future of the load in flight for
+    // `key`, or of a newly registered one whose id is stored in `launch_id`
+    // for the caller to launch() once unlocked (CallerRuns overflow would
+    // run the task on the caller's thread).
+    PoolFuture<V> join_or_register(const K& key, uint64_t& launch_id) {
+        auto it = loads.find(key);
+        if (it != loads.end()) return PoolFuture<V>(it->second.state);
+        auto state = std::make_shared<State>(pool);
+        launch_id = ++next_id;
+        loads.emplace(key, Load{state, launch_id});
+        ++running;
+        return PoolFuture<V>(state);
+    }
+
+    void launch(const K& key, std::shared_ptr<State> state, uint64_t id) {
+        pool.post(LoadTask(this, key, std::move(state), id));
+    }
+
+    // Runs on a worker. The value is cached before the waiters are woken,
+    // so one that asks again straight away hits.
+    void load(const K& key, std::shared_ptr<State> state, uint64_t id) {
+        std::optional<V> value;
+        try {
+            value.emplace(loader(key));
+        } catch (...) {
+            finish(key, id, nullptr);
+            state->set_error(std::current_exception());
+            return;
+        }
+        finish(key, id, &*value);
+        state->set_value(std::move(*value));
+    }
+
+    // Unregisters load `id`, caching `value` unless the load was detached.
+    void finish(const K& key, uint64_t id, const V* value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = loads.find(key);
+        if (it != loads.end() && it->second.id == id) {
+            loads.erase(it);
+            if (value) cache.put(key, *value);
+        }
+        if (--running == 0) idle.notify_all();
+    }
+
+    SimpleThreadPool& pool;
+    Cache cache;
+    Loader loader;
+    mutable std::mutex mutex;
+    std::condition_variable idle;
+    std::unordered_map<K, Load, typename Cache::hasher, typename Cache::key_equal> loads;
+    uint64_t next_id = 0;
+    size_t running = 0;   // load tasks not yet finished, detached ones included
+};
+
+#endif
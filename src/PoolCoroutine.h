@@ -0,0 +1,225 @@
+#ifndef POOL_COROUTINE_H
+#define POOL_COROUTINE_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "PoolCoroutine.h requires C++20 coroutines"
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "PoolFuture.h"
+#include "SimpleThreadPool.h"
+
+// Coroutine front end for SimpleThreadPool:
+//
+//   co_await schedule(pool);   // continue on a pool worker
+//   co_await some_pool_future; // suspend until a PoolFuture is ready
+//
+// CoroTask<T> is a lazily started coroutine; awaiting it starts it and the
+// awaiting coroutine is resumed (by symmetric transfer) when it finishes, so
+// no thread is blocked while work is outstanding. start() launches a task
+// concurrently as a PoolFuture, and sync_wait() is the bridge for
+// non-coroutine callers such as main() or tests.
+
+struct ScheduleAwaitable {
+    SimpleThreadPool& pool;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) const { pool.post([h] { h.resume(); }); }
+    void await_resume() const noexcept {}
+};
+
+inline ScheduleAwaitable schedule(SimpleThreadPool& pool) { return ScheduleAwaitable{pool}; }
+
+template<class T>
+struct PoolFutureAwaiter {
+    PoolFuture<T> future;
+
+    bool await_ready() const { return future.is_ready(); }
+    void await_suspend(std::coroutine_handle<> h) const {
+        future.shared_state()->on_ready([h] { h.resume(); });
+    }
+    decltype(auto) await_resume() const { return future.get(); }
+};
+
+template<class T>
+PoolFutureAwaiter<T> operator co_await(PoolFuture<T> future) { return PoolFutureAwaiter<T>{std::move(future)}; }
+
+template<class T> class CoroTask;
+
+namespace coro_detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template<class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) const noexcept {
+            return h.promise().continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template<class T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    CoroTask<T> get_return_object();
+    template<class V>
+    void return_value(V&& v) { value.emplace(std::forward<V>(v)); }
+    T result() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    CoroTask<void> get_return_object();
+    void return_void() noexcept {}
+    void result() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+// Eagerly started, self-destroying coroutine used by start and sync_wait.
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace coro_detail
+
+template<class T>
+class [[nodiscard]] CoroTask {
+public:
+    using promise_type = coro_detail::Promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    explicit CoroTask(handle_type h) noexcept : handle(h) {}
+    CoroTask(CoroTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    CoroTask& operator=(CoroTask&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    CoroTask(const CoroTask&) = delete;
+    CoroTask& operator=(const CoroTask&) = delete;
+    ~CoroTask() {
+        if (handle) handle.destroy();
+    }
+
+    struct Awaiter {
+        handle_type handle;
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+        T await_resume() { return handle.promise().result(); }
+    };
+
+    Awaiter operator co_await() && noexcept { return Awaiter{handle}; }
+
+private:
+    handle_type handle;
+};
+
+namespace coro_detail {
+
+template<class T>
+CoroTask<T> Promise<T>::get_return_object() {
+    return CoroTask<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline CoroTask<void> Promise<void>::get_return_object() {
+    return CoroTask<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+template<class T>
+struct SyncWaitState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    std::exception_ptr error;
+    std::optional<typename std::conditional<std::is_void<T>::value, bool, T>::type> value;
+};
+
+// The hop onto the pool is inside the try: a stopped or full pool rejects
+// the post, and that error belongs in the future, not in Detached (which
+// terminates).
+template<class T>
+Detached start_run(CoroTask<T> task, std::shared_ptr<PoolFutureState<T>> state, SimpleThreadPool& pool) {
+    try {
+        co_await schedule(pool);
+        if constexpr (std::is_void<T>::value) {
+            co_await std::move(task);
+            state->set_value();
+        } else {
+            state->set_value(co_await std::move(task));
+        }
+    } catch (...) {
+        state->set_error(std::current_exception());
+    }
+}
+
+template<class T>
+Detached sync_wait_run(CoroTask<T>& task, SyncWaitState<T>* state) {
+    try {
+        if constexpr (std::is_void<T>::value) {
+            co_await std::move(task);
+        } else {
+            state->value.emplace(co_await std::move(task));
+        }
+    } catch (...) {
+        state->error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->done = true;
+    state->cv.notify_all();
+}
+
+} // namespace coro_detail
+
+// Starts the task on a pool worker right away and returns a PoolFuture for
+// its result, so many tasks can be in flight at once and joined with
+// when_all/when_any or co_await.
+template<class T>
+PoolFuture<T> start(SimpleThreadPool& pool, CoroTask<T> task) {
+    auto state = std::make_shared<PoolFutureState<T>>(pool);
+    coro_detail::start_run(std::move(task), state, pool);
+    return PoolFuture<T>(state);
+}
+
+// Runs the task to completion, blocking the calling thread. Must not be
+// called from a pool worker whose pool the task needs to make progress.
+template<class T>
+T sync_wait(CoroTask<T> task) {
+    coro_detail::SyncWaitState<T> state;
+    coro_detail::sync_wait_run(task, &state);
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.cv.wait(lock, [&] { return state.done; });
+    if (state.error) std::rethrow_exception(state.error);
+    if constexpr (!std::is_void<T>::value) return std::move(*state.value);
+}
+
+#endif
@@ -0,0 +1,372 @@
+#ifndef POOL_FUTURE_H
+#define POOL_FUTURE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "SimpleThreadPool.h"
+
+// Futures whose dependent work is scheduled on a SimpleThreadPool when they
+// complete, instead of by a thread blocking in get(). Completion posts every
+// attached continuation to the pool, so chains, when_all/when_any joins and
+// TaskGraph runs never park a worker. get()/wait() remain for callers outside
+// the pool that need the final result.
+
+template<class T> class PoolFuture;
+
+// Result of a continuation attached to a PoolFuture<T>.
+template<class T, class Fn>
+struct ContinuationResult { using type = std::invoke_result_t<Fn&, const T&>; };
+template<class Fn>
+struct ContinuationResult<void, Fn> { using type = std::invoke_result_t<Fn&>; };
+
+template<class T>
+class PoolFutureState {
+public:
+    struct Unit {};
+    using Stored = typename std::conditional<std::is_void<T>::value, Unit, T>::type;
+
+    explicit PoolFutureState(SimpleThreadPool& p) : pool(&p) {}
+
+    template<class... V>
+    void set_value(V&&... v) {
+        std::vector<TaskFunction> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done) throw std::logic_error("PoolFuture already satisfied");
+            value.emplace(std::forward<V>(v)...);
+            done = true;
+            ready.swap(continuations);
+        }
+        finish(std::move(ready));
+    }
+
+    void set_error(std::exception_ptr e) {
+        std::vector<TaskFunction> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done) throw std::logic_error("PoolFuture already satisfied");
+            error = std::move(e);
+            done = true;
+            ready.swap(continuations);
+        }
+        finish(std::move(ready));
+    }
+
+    // Stores fn()'s result, or the exception it throws.
+    template<class Fn>
+    void fulfil(Fn&& fn) {
+        try {
+            if constexpr (std::is_void<T>::value) {
+                fn();
+                set_value();
+            } else {
+                set_value(fn());
+            }
+        } catch (...) {
+            set_error(std::current_exception());
+        }
+    }
+
+    // Fails the state with broken_promise unless it is already satisfied;
+    // used when the task that would have satisfied it is discarded.
+    void abandon() {
+        std::vector<TaskFunction> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done) return;
+            error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+            done = true;
+            ready.swap(continuations);
+        }
+        finish(std::move(ready));
+    }
+
+    // Posts k to the pool once this state is satisfied (immediately if it
+    // already is).
+    void on_ready(TaskFunction k) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!done) {
+                continuations.push_back(std::move(k));
+                return;
+            }
+        }
+        pool->post(std::move(k));
+    }
+
+    bool is_ready() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return done;
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return done; });
+    }
+
+    // Only valid once ready.
+    const Stored& stored() const { return *value; }
+
+    SimpleThreadPool* pool;
+    std::exception_ptr error;
+
+private:
+    void finish(std::vector<TaskFunction> ready) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cv.notify_all();
+        }
+        if (ready.empty()) return;
+        try {
+            pool->post_bulk(std::move(ready));
+        } catch (const QueueFullError&) {
+            // A bounded pool had no room (post_bulk takes all or none). The
+            // continuations are ready to run, and dropping them would lose
+            // their results and strand any coroutine awaiting this future,
+            // so run them here, as OverflowPolicy::CallerRuns would.
+            for (TaskFunction& k : ready) k();
+        } catch (const std::runtime_error&) {
+            // The pool is stopped and rejected them; dropping `ready`
+            // abandons whatever those continuations would have completed.
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    std::optional<Stored> value;
+    std::vector<TaskFunction> continuations;
+};
+
+// Pool task that completes `target`. If the pool discards it without running
+// it (ShutdownPolicy::Discard), the target is abandoned instead of being left
+// pending forever.
+template<class T, class Fn>
+struct CompletionTask {
+    CompletionTask(std::shared_ptr<PoolFutureState<T>> t, Fn f) : target(std::move(t)), fn(std::move(f)) {}
+    CompletionTask(CompletionTask&&) = default;
+    ~CompletionTask() {
+        if (target) target->abandon();
+    }
+
+    void operator()() {
+        fn();
+        target.reset();
+    }
+
+    std::shared_ptr<PoolFutureState<T>> target;
+    Fn fn;
+};
+
+template<class T, class Fn>
+CompletionTask<T, Fn> completes(const std::shared_ptr<PoolFutureState<T>>& target, Fn fn) {
+    return CompletionTask<T, Fn>(target, std::move(fn));
+}
+
+template<class T>
+class PoolFuture {
+public:
+    using value_type = T;
+
+    PoolFuture() = default;
+    explicit PoolFuture(std::shared_ptr<PoolFutureState<T>> s) : state(std::move(s)) {}
+
+    bool valid() const { return state != nullptr; }
+    bool is_ready() const { return state->is_ready(); }
+    void wait() const { state->wait(); }
+
+    // Blocks the caller; meant for threads outside the pool.
+    decltype(auto) get() const {
+        state->wait();
+        if (state->error) std::rethrow_exception(state->error);
+        if constexpr (!std::is_void<T>::value) return static_cast<const T&>(state->stored());
+    }
+
+    // Schedules f(value) (or f() for PoolFuture<void>) on the pool once this
+    // future is ready. An exception here skips f and propagates to the result.
+    template<class F>
+    auto then(F&& f) const {
+        using Fn = typename std::decay<F>::type;
+        using R = typename ContinuationResult<T, Fn>::type;
+        auto next = std::make_shared<PoolFutureState<R>>(*state->pool);
+        state->on_ready(completes(next, [src = state, next, fn = Fn(std::forward<F>(f))]() mutable {
+            if (src->error) {
+                next->set_error(src->error);
+                return;
+            }
+            next->fulfil([&]() -> R {
+                if constexpr (std::is_void<T>::value) return fn();
+                else return fn(static_cast<const T&>(src->stored()));
+            });
+        }));
+        return PoolFuture<R>(next);
+    }
+
+    const std::shared_ptr<PoolFutureState<T>>& shared_state() const { return state; }
+
+private:
+    std::shared_ptr<PoolFutureState<T>> state;
+};
+
+// Runs f(args...) on the pool and returns a PoolFuture for its result.
+template<class F, class... Args>
+auto spawn(SimpleThreadPool& pool, F&& f, Args&&... args)
+    -> PoolFuture<std::invoke_result_t<typename std::decay<F>::type&, typename std::decay<Args>::type&...>> {
+    using R = std::invoke_result_t<typename std::decay<F>::type&, typename std::decay<Args>::type&...>;
+    auto state = std::make_shared<PoolFutureState<R>>(pool);
+    pool.post(completes(state, [state, fn = std::forward<F>(f), bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        state->fulfil([&]() -> R { return std::apply(fn, bound); });
+    }));
+    return PoolFuture<R>(state);
+}
+
+// Ready once every input is; yields their values in input order, or the first
+// input error (by position). An empty input is immediately ready.
+template<class T>
+auto when_all(SimpleThreadPool& pool, const std::vector<PoolFuture<T>>& inputs) {
+    using R = typename std::conditional<std::is_void<T>::value, void, std::vector<T>>::type;
+    auto result = std::make_shared<PoolFutureState<R>>(pool);
+    auto join = [inputs, result] {
+        for (const auto& in : inputs) {
+            if (in.shared_state()->error) {
+                result->set_error(in.shared_state()->error);
+                return;
+            }
+        }
+        result->fulfil([&]() -> R {
+            if constexpr (!std::is_void<T>::value) {
+                std::vector<T> values;
+                values.reserve(inputs.size());
+                for (const auto& in : inputs) values.push_back(in.shared_state()->stored());
+                return values;
+            }
+        });
+    };
+    if (inputs.empty()) {
+        join();
+        return PoolFuture<R>(result);
+    }
+    auto remaining = std::make_shared<std::atomic<size_t>>(inputs.size());
+    auto shared_join = std::make_shared<decltype(join)>(std::move(join));
+    for (const auto& in : inputs) {
+        in.shared_state()->on_ready(completes(result, [remaining, shared_join] {
+            if (remaining->fetch_sub(1) == 1) (*shared_join)();
+        }));
+    }
+    return PoolFuture<R>(result);
+}
+
+// Ready as soon as any input is; yields the index of the first input to
+// complete (with a value or an error).
+template<class T>
+PoolFuture<size_t> when_any(SimpleThreadPool& pool, const std::vector<PoolFuture<T>>& inputs) {
+    if (inputs.empty()) throw std::invalid_argument("when_any needs at least one future");
+    auto result = std::make_shared<PoolFutureState<size_t>>(pool);
+    auto claimed = std::make_shared<std::atomic<bool>>(false);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        inputs[i].shared_state()->on_ready(completes(result, [result, claimed, i] {
+            if (!claimed->exchange(true)) result->set_value(i);
+        }));
+    }
+    return PoolFuture<size_t>(result);
+}
+
+// A DAG of void tasks. Each node is posted to the pool as soon as its last
+// dependency finishes; nothing ever waits on a dependency. After a node
+// throws, nodes that have not started yet are skipped and the run's future
+// carries that first exception.
+class TaskGraph {
+public:
+    using NodeId = size_t;
+
+    NodeId add(std::function<void()> fn, std::initializer_list<NodeId> deps = {}) {
+        return add(std::move(fn), std::vector<NodeId>(deps));
+    }
+
+    NodeId add(std::function<void()> fn, const std::vector<NodeId>& deps) {
+        NodeId id = nodes.size();
+        for (NodeId d : deps)
+            if (d >= id) throw std::invalid_argument("TaskGraph dependency does not exist");
+        nodes.push_back(Node{std::move(fn), {}, deps.size()});
+        for (NodeId d : deps) nodes[d].successors.push_back(id);
+        return id;
+    }
+
+    size_t size() const { return nodes.size(); }
+
+    // Schedules the whole graph; the graph may be reused or destroyed while
+    // the run is in flight.
+    PoolFuture<void> run(SimpleThreadPool& pool) const {
+        auto result = std::make_shared<PoolFutureState<void>>(pool);
+        if (nodes.empty()) {
+            result->set_value();
+            return PoolFuture<void>(result);
+        }
+        auto run_state = std::make_shared<RunState>(pool, nodes, result);
+        std::vector<TaskFunction> roots;
+        for (NodeId i = 0; i < nodes.size(); ++i)
+            if (nodes[i].dependencies == 0)
+                roots.emplace_back(completes(result, [run_state, i] { RunState::execute(run_state, i); }));
+        pool.post_bulk(std::move(roots));
+        return PoolFuture<void>(result);
+    }
+
+private:
+    struct Node {
+        std::function<void()> fn;
+        std::vector<NodeId> successors;
+        size_t dependencies;
+    };
+
+    struct RunState {
+        RunState(SimpleThreadPool& p, const std::vector<Node>& n, std::shared_ptr<PoolFutureState<void>> r)
+            : pool(p), nodes(n), remaining(n.size()), left(n.size()), result(std::move(r)) {
+            for (size_t i = 0; i < nodes.size(); ++i) remaining[i].store(nodes[i].dependencies);
+        }
+
+        static void execute(const std::shared_ptr<RunState>& self, NodeId id) {
+            if (!self->failed.load()) {
+                try {
+                    self->nodes[id].fn();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(self->error_mutex);
+                    if (!self->error) self->error = std::current_exception();
+                    self->failed = true;
+                }
+            }
+            std::vector<TaskFunction> ready;
+            for (NodeId s : self->nodes[id].successors)
+                if (self->remaining[s].fetch_sub(1) == 1)
+                    ready.emplace_back(completes(self->result, [self, s] { RunState::execute(self, s); }));
+            if (!ready.empty()) self->pool.post_bulk(std::move(ready));
+            if (self->left.fetch_sub(1) == 1) {
+                if (self->error) self->result->set_error(self->error);
+                else self->result->set_value();
+            }
+        }
+
+        SimpleThreadPool& pool;
+        std::vector<Node> nodes;
+        std::vector<std::atomic<size_t>> remaining;
+        std::atomic<size_t> left;
+        std::atomic<bool> failed{false};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        std::shared_ptr<PoolFutureState<void>> result;
+    };
+
+    std::vector<Node> nodes;
+};
+
+#endif
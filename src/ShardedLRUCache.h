@@ -0,0 +1,90 @@
+#ifndef SHARDED_LRUCACHE_H
+#define SHARDED_LRUCACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include "LRUCache.h"
+
+// Thread-safe LRU cache built from independently locked LRUCache segments.
+// Keys are hashed to a shard, so threads touching different shards never
+// contend; recency (and eviction) is tracked per shard, which makes the whole
+// cache an approximation of a global LRU. The capacity is split as evenly as
+// possible, and the shard count is capped at the capacity so every shard can
+// hold at least one entry.
+template<class K = int, class V = int, class Hash = std::hash<K>>
+class ShardedLRUCache {
+public:
+    explicit ShardedLRUCache(size_t capacity, size_t shards = 16, const Hash& hash = Hash()) : hash_fn(hash) {
+        if (capacity == 0) throw std::invalid_argument("Capacity must be positive");
+        if (shards == 0) throw std::invalid_argument("Shard count must be positive");
+        count = 1;
+        bits = 0;
+        while (count * 2 <= shards && count * 2 <= capacity) {
+            count *= 2;
+            ++bits;
+        }
+        segments.reset(new Shard[count]);
+        for (size_t i = 0; i < count; ++i)
+            segments[i].cache.reset(new LRUCache<K, V, Hash>(capacity / count + (i < capacity % count ? 1 : 0)));
+    }
+
+    V get(const K& key) {
+        Shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.cache->get(key);
+    }
+
+    template<class KK, class VV>
+    void put(KK&& key, VV&& value) {
+        Shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.cache->put(std::forward<KK>(key), std::forward<VV>(value));
+    }
+
+    // Sum over shards; only a snapshot while other threads are writing.
+    size_t size() const {
+        size_t n = 0;
+        for (size_t i = 0; i < count; ++i) {
+            std::lock_guard<std::mutex> lock(segments[i].mutex);
+            n += segments[i].cache->size();
+        }
+        return n;
+    }
+
+    size_t shard_count() const { return count; }
+
+    // Index of the shard `key` belongs in. std::hash<int> is the identity, so
+    // the bits are mixed first, with murmur3's finalizer rather than the
+    // Fibonacci hashing LRUCache buckets with: picking both from the top bits
+    // of the same product would leave every key in a shard with the same top
+    // bucket bits, using only 1 / shard_count() of the shard's buckets.
+    size_t shard_of(const K& key) const {
+        if (count == 1) return 0;
+        uint64_t h = static_cast<uint64_t>(hash_fn(key));
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h >> (64 - bits));
+    }
+
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unique_ptr<LRUCache<K, V, Hash>> cache;
+    };
+
+    Shard& shard_for(const K& key) { return segments[shard_of(key)]; }
+
+    Hash hash_fn;
+    std::unique_ptr<Shard[]> segments;
+    size_t count;
+    unsigned bits;
+};
+
+#endif
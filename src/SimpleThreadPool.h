@@ -2,7 +2,7 @@
 #define SIMPLE_THREAD_POOL_H
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -10,58 +10,1144 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <chrono>
+#include <optional>
+#include "CancellationToken.h"
+#include "CpuTopology.h"
+#include "MpmcRing.h"
+#include "SlabAllocator.h"
+#include "TaskFunction.h"
+#include "ThreadPoolMetrics.h"
+#include "TimerWheel.h"
+
+// SharedQueue: every worker pulls from the global queue, one FIFO lane per
+// priority. Each lane is a bounded lock-free ring (ring_size slots);
+// submissions that find it full spill into the lane's overflow deque, so
+// enqueue never blocks or fails.
+// WorkStealing: each worker owns a deque; tasks enqueued from inside a worker
+// go to its own deque (LIFO for the owner), idle workers steal from the
+// opposite end of a random peer, and the global queue only serves external
+// submitters and non-default priorities.
+enum class SchedulingMode { SharedQueue, WorkStealing };
+
+// Lanes are served highest priority first, except that every
+// starvation_interval-th task a worker takes is looked for lowest priority
+// first, so Background work keeps making progress under Interactive load.
+enum class TaskPriority { Interactive, Normal, Background };
+
+// None leaves placement to the OS. RoundRobin pins worker i to the i-th CPU
+// (in NUMA node order); CpuList pins it to cpus[i % cpus.size()].
+enum class AffinityMode { None, RoundRobin, CpuList };
+
+// What a submission does when max_queued tasks are already waiting. Block
+// parks the producer until a worker takes a task; Reject throws
+// QueueFullError; CallerRuns runs the task on the submitting thread;
+// DropOldest discards the oldest queued tasks (lowest priority first),
+// breaking their promises. Submissions from the pool's own workers are never
+// blocked or rejected, since that could deadlock the pool.
+enum class OverflowPolicy { Block, Reject, CallerRuns, DropOldest };
+
+struct QueueFullError : std::runtime_error {
+    QueueFullError() : std::runtime_error("ThreadPool queue is full") {}
+};
+
+// Identifies a timer created by schedule_at/after/every; 0 is never used.
+using TimerId = uint64_t;
+
+struct ThreadPoolOptions {
+    SchedulingMode mode = SchedulingMode::SharedQueue;
+    size_t ring_size = 1024;
+    // Polls of the pending count before an idle worker parks on the condvar.
+    unsigned spin_count = 64;
+    // 0 disables starvation protection (strict priority).
+    unsigned starvation_interval = 32;
+
+    // Elastic sizing. With max_threads above the constructor's thread count,
+    // a worker is added whenever tasks have been waiting with no idle worker
+    // for longer than grow_after, and workers idle for idle_timeout retire,
+    // never going below min_threads (0 means 1). resize() works regardless.
+    size_t max_threads = 0;
+    size_t min_threads = 0;
+    std::chrono::microseconds grow_after{1000};
+    std::chrono::milliseconds idle_timeout{5000};
+
+    AffinityMode affinity = AffinityMode::None;
+    std::vector<int> cpus;
+    // Gives every NUMA node its own set of priority lanes. Workers serve their
+    // node's lanes before the others', and unpinned workers are spread across
+    // nodes and confined to their node's CPUs. On a single-node machine this
+    // is the same as a plain pool.
+    bool numa_aware = false;
+
+    // Task start/stop events kept per worker for write_chrome_trace(). Only
+    // used when built with SIMPLE_THREAD_POOL_METRICS.
+    size_t trace_events = 0;
+
+    // Most tasks allowed to wait in the queues; 0 means unbounded.
+    size_t max_queued = 0;
+    OverflowPolicy overflow = OverflowPolicy::Block;
+
+    // Resolution of schedule_at/after/every; timers fire up to one tick late.
+    std::chrono::microseconds timer_tick{1000};
+};
+
+// Drain runs every queued task before the workers exit. DrainWithDeadline
+// does the same until the deadline, then discards what is left. Discard
+// drops queued tasks straight away: enqueue'd futures report broken_promise
+// and tasks already running finish (or notice stop_token() and bail out).
+enum class ShutdownPolicy { Drain, DrainWithDeadline, Discard };
+
+struct SubmitOptions {
+    TaskPriority priority = TaskPriority::Normal;
+    // Tasks that have not started by the deadline are dropped instead of run;
+    // futures of dropped enqueue'd tasks report broken_promise. The default
+    // (epoch) means no deadline.
+    std::chrono::steady_clock::time_point deadline{};
+    // Preferred NUMA node for numa_aware pools; -1 picks the submitting
+    // thread's node. Other nodes' workers still take the task when idle.
+    int node = -1;
+    // Tasks whose token is cancelled before they start are dropped like
+    // expired ones. Pass the token to the task as well to let it stop early.
+    CancellationToken cancel;
+};
 
 class SimpleThreadPool {
 public:
-    explicit SimpleThreadPool(size_t threads) : stop(false) {
+    explicit SimpleThreadPool(size_t threads, ThreadPoolOptions opts = ThreadPoolOptions())
+        : options(opts), metrics(std::max(threads, opts.max_threads), opts.trace_events), stop(false) {
         if (threads == 0) throw std::invalid_argument("Thread pool size must be positive.");
-        for(size_t i = 0; i < threads; ++i)
-            workers.emplace_back([this] {
-                for(;;) {
-                    std::function<void()> task;
-                    {
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
-                        this->condition.wait(lock, [this]{ return this->stop || !this->tasks.empty(); });
-                        if(this->stop && this->tasks.empty()) return;
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
-                    }
-                    task();
-                }
-            });
+        if (opts.affinity == AffinityMode::CpuList && opts.cpus.empty())
+            throw std::invalid_argument("CpuList affinity needs at least one CPU.");
+        const CpuTopology& topology = CpuTopology::instance();
+        nodes = opts.numa_aware ? topology.node_count() : 1;
+        for (size_t i = 0; i < nodes * priority_count; ++i)
+            lanes.emplace_back(new Lane(opts.ring_size));
+        // Slots are allocated up front so stealing can scan them without
+        // locking while workers come and go.
+        const size_t slots = std::max(threads, opts.max_threads);
+        for(size_t i = 0; i < slots; ++i) {
+            workers.emplace_back(new Worker(i));
+            place(*workers.back(), i, topology);
+        }
+        elastic = opts.max_threads > threads;
+        min_active = std::max<size_t>(1, std::min(opts.min_threads, threads));
+        std::lock_guard<std::mutex> lock(resize_mutex);
+        target.store(threads);
+        for(size_t i = 0; i < threads; ++i) start_worker(i);
     }
 
+    // The callable and its bound arguments are stored by value inside the
+    // task (no std::function/packaged_task), and the future's shared state is
+    // carved from the pool's slab, so small tasks enqueue without malloc.
     template<class F, class... Args>
-    auto enqueue(F&& f, Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type> {
-        using return_type = typename std::result_of<F(Args...)>::type;
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-        );
-        std::future<return_type> res = task->get_future();
+    auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type> {
+        using return_type = typename std::invoke_result<F, Args...>::type;
+        std::future<return_type> res;
+        submit(make_task(res, std::forward<F>(f), std::forward<Args>(args)...));
+        return res;
+    }
+
+    // enqueue with a priority lane and/or deadline.
+    template<class F, class... Args>
+    auto enqueue_with(const SubmitOptions& opts, F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type> {
+        using return_type = typename std::invoke_result<F, Args...>::type;
+        std::future<return_type> res;
+        submit(with_guards(opts, make_callable(res, std::forward<F>(f), std::forward<Args>(args)...)),
+               opts.priority, opts.node);
+        return res;
+    }
+
+    // Fails fast instead of applying the overflow policy: returns nothing when
+    // the queue is at capacity.
+    template<class F, class... Args>
+    auto try_enqueue(F&& f, Args&&... args) -> std::optional<std::future<typename std::invoke_result<F, Args...>::type>> {
+        using return_type = typename std::invoke_result<F, Args...>::type;
+        std::future<return_type> res;
+        auto make = [&](size_t) { return make_task(res, std::forward<F>(f), std::forward<Args>(args)...); };
+        if (!submit_bulk(1, make, TaskPriority::Normal, -1, true)) return std::nullopt;
+        return std::optional<std::future<return_type>>(std::move(res));
+    }
+
+    // Batch submission: tasks are queued ring_size at a time, and each step
+    // takes the overflow lock at most once and then notifies min(step, idle)
+    // sleeping workers, so workers start on a large batch before it is all
+    // queued.
+    template<class It, class = typename std::iterator_traits<It>::iterator_category>
+    auto enqueue_bulk(It first, It last)
+        -> std::vector<std::future<typename std::invoke_result<typename std::iterator_traits<It>::reference>::type>> {
+        using return_type = typename std::invoke_result<typename std::iterator_traits<It>::reference>::type;
+        std::vector<std::future<return_type>> futures(static_cast<size_t>(std::distance(first, last)));
+        submit_bulk(futures.size(), [&](size_t i) {
+            Task task = make_task(futures[i], *first);
+            ++first;
+            return task;
+        });
+        return futures;
+    }
+
+    // Submits f(0) .. f(count - 1).
+    template<class F>
+    auto enqueue_bulk(size_t count, F f) -> std::vector<std::future<typename std::invoke_result<F&, size_t>::type>> {
+        using return_type = typename std::invoke_result<F&, size_t>::type;
+        std::vector<std::future<return_type>> futures(count);
+        submit_bulk(count, [&](size_t i) { return make_task(futures[i], f, i); });
+        return futures;
+    }
+
+    // Calls fn(i) for every i in [begin, end), split into chunks of `grain`
+    // indices (0 picks about four chunks per worker). Chunks are claimed from
+    // a shared counter by up to size() helper tasks and by the calling thread
+    // itself, so this is safe to call from inside a worker. Blocks until every
+    // chunk has finished and rethrows the first exception thrown by fn.
+    template<class Index, class F>
+    void parallel_for(Index begin, Index end, Index grain, F&& fn) {
+        if (!(begin < end)) return;
+        const size_t total = static_cast<size_t>(end - begin);
+        size_t chunk = grain > Index(0) ? static_cast<size_t>(grain) : total / (size() * 4);
+        if (chunk == 0) chunk = 1;
+        const size_t chunks = (total + chunk - 1) / chunk;
+
+        auto body = [&fn, begin, end, chunk](size_t c) {
+            Index lo = static_cast<Index>(begin + static_cast<Index>(c * chunk));
+            Index hi = (end - lo) > static_cast<Index>(chunk) ? static_cast<Index>(lo + static_cast<Index>(chunk)) : end;
+            for (Index i = lo; i < hi; ++i) fn(i);
+        };
+        using Body = decltype(body);
+        auto state = std::make_shared<ParallelForState>(chunks);
+        const Body* body_ptr = &body;
+        submit_bulk(std::min(chunks - 1, size()), [&](size_t) {
+            return Task([state, body_ptr] { state->run(*body_ptr); });
+        });
+        state->run(body);
+        state->wait();
+    }
+
+    // Fire-and-forget submission: no promise or shared state, just the queue
+    // push. Exceptions escaping the callable go to the error handler.
+    template<class F>
+    void post(F&& f) {
+        submit(Task(std::forward<F>(f)));
+    }
+
+    // post() that fails fast like try_enqueue; returns whether f was queued.
+    template<class F>
+    bool try_post(F&& f) {
+        return submit_bulk(1, [&](size_t) { return Task(std::forward<F>(f)); }, TaskPriority::Normal, -1, true);
+    }
+
+    template<class F>
+    void post_with(const SubmitOptions& opts, F&& f) {
+        submit(with_guards(opts, std::forward<F>(f)), opts.priority, opts.node);
+    }
+
+    // Queues every element of the range with a single wake-up; elements are
+    // moved out when the range is an rvalue.
+    template<class Range>
+    void post_bulk(Range&& callables) {
+        using std::begin;
+        using std::end;
+        auto it = begin(callables);
+        const size_t n = static_cast<size_t>(std::distance(it, end(callables)));
+        submit_bulk(n, [&](size_t) {
+            Task task;
+            if constexpr (std::is_rvalue_reference<Range&&>::value) task = Task(std::move(*it));
+            else task = Task(*it);
+            ++it;
+            return task;
+        });
+    }
+
+    // Timers. Due callbacks are posted to the pool like post(); there is no
+    // timer thread: busy workers check the wheel between tasks and one parked
+    // worker sleeps until the next expiry. Timers still pending at shutdown
+    // are dropped.
+    template<class F>
+    TimerId schedule_at(std::chrono::steady_clock::time_point when, F&& f) {
+        return add_timer(when, 0, TimerEntry{Task(std::forward<F>(f)), nullptr});
+    }
+
+    template<class Rep, class Period, class F>
+    TimerId schedule_after(std::chrono::duration<Rep, Period> delay, F&& f) {
+        return schedule_at(std::chrono::steady_clock::now() + delay, std::forward<F>(f));
+    }
+
+    // Runs f every `period` (rounded up to whole ticks), first after one
+    // period. A run that is still going when the next is due skips that
+    // occurrence rather than overlapping it.
+    template<class Rep, class Period, class F>
+    TimerId schedule_every(std::chrono::duration<Rep, Period> period, F&& f) {
+        const int64_t tick_ns = timer_tick_ns();
+        const int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(period).count();
+        const uint64_t ticks = static_cast<uint64_t>(std::max<int64_t>(1, (ns + tick_ns - 1) / tick_ns));
+        auto periodic = std::make_shared<PeriodicTimer>(Task(std::forward<F>(f)));
+        return add_timer(std::chrono::steady_clock::now() + period, ticks, TimerEntry{Task(), std::move(periodic)});
+    }
+
+    // Returns false if the timer already fired (one-shot) or was cancelled.
+    bool cancel_timer(TimerId id) {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        return timers.cancel(id);
+    }
+
+    // Receives exceptions thrown by posted tasks. Without a handler they are
+    // discarded.
+    void set_error_handler(std::function<void(std::exception_ptr)> handler) {
+        std::lock_guard<std::mutex> lock(handler_mutex);
+        error_handler = std::move(handler);
+    }
+
+    // Adds or retires workers until n are running. Surplus workers finish
+    // their current task, hand their local deque back to the global queue and
+    // exit; n may not exceed capacity().
+    void resize(size_t n) {
+        if (n == 0 || n > workers.size()) throw std::invalid_argument("Invalid thread pool size.");
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            if(stop) throw std::runtime_error("enqueue on stopped ThreadPool");
-            tasks.emplace([task](){ (*task)(); });
+            std::lock_guard<std::mutex> lock(resize_mutex);
+            if (stop) throw std::runtime_error("resize on stopped ThreadPool");
+            target.store(n);
+            while (active.load() < n) {
+                // Slots still held by retiring workers free up shortly.
+                for (size_t i = 0; i < workers.size() && active.load() < n; ++i)
+                    if (!workers[i]->running.load()) start_worker(i);
+                if (active.load() < n) std::this_thread::yield();
+            }
         }
-        condition.notify_one();
-        return res;
+        { std::lock_guard<std::mutex> lock(queue_mutex); }
+        condition.notify_all();
     }
 
-    ~SimpleThreadPool() {
+    // Number of running workers.
+    size_t size() const { return active.load(); }
+    // Largest size the pool can reach.
+    size_t capacity() const { return workers.size(); }
+    // Number of NUMA nodes with their own queues (1 unless numa_aware).
+    size_t node_count() const { return nodes; }
+
+#ifdef SIMPLE_THREAD_POOL_METRICS
+    // Per-worker counters and merged latency histograms; safe to call while
+    // the pool is running.
+    ThreadPoolMetrics::Snapshot metrics_snapshot() const { return metrics.snapshot(pending.load()); }
+
+    void write_chrome_trace(std::ostream& out) const { metrics.write_chrome_trace(out); }
+#endif
+    SchedulingMode mode() const { return options.mode; }
+
+    // Blocks until every submitted task has finished (or been dropped). Tasks
+    // submitted meanwhile are waited for too. Must not be called from a worker.
+    void wait_idle() {
+        wait_idle_until(std::chrono::steady_clock::time_point::max());
+    }
+
+    // As wait_idle(), giving up after `timeout`; returns whether the pool went idle.
+    template<class Rep, class Period>
+    bool wait_idle_for(std::chrono::duration<Rep, Period> timeout) {
+        return wait_idle_until(std::chrono::steady_clock::now()
+                               + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout));
+    }
+
+    // Cancelled when shutdown starts discarding queued work, so long-running
+    // tasks can give up early.
+    CancellationToken stop_token() const { return stop_source.token(); }
+
+    // Stops accepting external submissions and retires every worker according
+    // to `policy`; `drain_timeout` bounds DrainWithDeadline. While draining,
+    // tasks may still submit follow-up work from inside the pool. Only the
+    // first call has an effect; later ones wait for it to complete.
+    void shutdown(ShutdownPolicy policy = ShutdownPolicy::Drain,
+                  std::chrono::steady_clock::duration drain_timeout = std::chrono::steady_clock::duration::zero()) {
+        if (current_context().pool == this) throw std::logic_error("shutdown called from a pool worker");
+        std::lock_guard<std::mutex> once(shutdown_mutex);
+        if (shut_down) return;
+        shut_down = true;
+        if (policy == ShutdownPolicy::Discard) begin_discard();
         {
             std::unique_lock<std::mutex> lock(queue_mutex);
             stop = true;
         }
         condition.notify_all();
-        for(std::thread &worker: workers) worker.join();
+        notify_space();
+        close_timers();
+        if (policy == ShutdownPolicy::DrainWithDeadline
+            && !wait_idle_until(std::chrono::steady_clock::now() + drain_timeout)) {
+            begin_discard();
+        }
+        {
+            std::lock_guard<std::mutex> lock(resize_mutex);
+            for(auto &worker: workers)
+                if (worker->thread.joinable()) worker->thread.join();
+        }
+        // Workers are gone; whatever is still queued is dropped here.
+        discard_queued();
+    }
+
+    ~SimpleThreadPool() {
+        shutdown(ShutdownPolicy::Drain);
     }
 
 private:
-    std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+#ifdef SIMPLE_THREAD_POOL_METRICS
+    using Metrics = ThreadPoolMetrics;
+#else
+    using Metrics = NullThreadPoolMetrics;
+#endif
+    using Task = Metrics::Task;
+
+    // Runs fn(args...) with bound arguments passed as lvalues, like std::bind,
+    // and publishes the result or exception through the promise.
+    template<class R, class Fn, class ArgTuple>
+    struct PromiseTask {
+        template<class F, class... A>
+        PromiseTask(std::promise<R>&& p, F&& f, A&&... a)
+            : promise(std::move(p)), fn(std::forward<F>(f)), args(std::forward<A>(a)...) {}
+
+        void operator()() {
+            try {
+                run(std::is_void<R>());
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        }
+
+        void run(std::true_type) { std::apply(fn, args); promise.set_value(); }
+        void run(std::false_type) { promise.set_value(std::apply(fn, args)); }
+
+        std::promise<R> promise;
+        Fn fn;
+        ArgTuple args;
+    };
+
+    template<class R, class F, class... Args>
+    PromiseTask<R, typename std::decay<F>::type, std::tuple<typename std::decay<Args>::type...>>
+    make_callable(std::future<R>& res, F&& f, Args&&... args) {
+        std::promise<R> promise(std::allocator_arg, SlabAllocator<char>(slab));
+        res = promise.get_future();
+        return {std::move(promise), std::forward<F>(f), std::forward<Args>(args)...};
+    }
+
+    template<class R, class F, class... Args>
+    Task make_task(std::future<R>& res, F&& f, Args&&... args) {
+        return Task(make_callable(res, std::forward<F>(f), std::forward<Args>(args)...));
+    }
+
+    // Drops (destroys without running) the callable once its deadline passed
+    // or its token was cancelled.
+    template<class Fn>
+    struct GuardedTask {
+        void operator()() {
+            if (cancel.cancelled()) return;
+            if (deadline != std::chrono::steady_clock::time_point{} && std::chrono::steady_clock::now() > deadline) return;
+            fn();
+        }
+        Fn fn;
+        std::chrono::steady_clock::time_point deadline;
+        CancellationToken cancel;
+    };
+
+    template<class F>
+    static Task with_guards(const SubmitOptions& opts, F&& f) {
+        using Fn = typename std::decay<F>::type;
+        if (opts.deadline == std::chrono::steady_clock::time_point{} && !opts.cancel.can_be_cancelled())
+            return Task(std::forward<F>(f));
+        return Task(GuardedTask<Fn>{Fn(std::forward<F>(f)), opts.deadline, opts.cancel});
+    }
+
+    // Shared between parallel_for's caller and its helper tasks. Helpers that
+    // start after every chunk is claimed return without touching the body,
+    // which lives on the caller's stack.
+    struct ParallelForState {
+        explicit ParallelForState(size_t n) : chunks(n) {}
+
+        template<class Body>
+        void run(const Body& body) {
+            for (;;) {
+                size_t c = next.fetch_add(1);
+                if (c >= chunks) return;
+                if (!failed.load()) {
+                    try {
+                        body(c);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error) error = std::current_exception();
+                        failed = true;
+                    }
+                }
+                if (done.fetch_add(1) + 1 == chunks) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this] { return done.load() == chunks; });
+            if (error) std::rethrow_exception(error);
+        }
+
+        const size_t chunks;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+
+    struct alignas(64) Worker {
+        explicit Worker(size_t index) : rng_state(0x9E3779B97F4A7C15ull * (index + 1)) {}
+        std::mutex mutex;
+        std::deque<Task> local;
+        std::thread thread;
+        uint64_t rng_state;
+        unsigned global_pops = 0;
+        std::atomic<bool> running{false};
+        size_t node = 0;
+        std::vector<int> cpus;   // empty: unpinned
+    };
+
+    // Chooses slot i's CPUs and node from the affinity options.
+    void place(Worker& w, size_t i, const CpuTopology& topology) {
+        int cpu = -1;
+        if (options.affinity == AffinityMode::RoundRobin) {
+            const std::vector<int> all = topology.all_cpus();
+            cpu = all[i % all.size()];
+        } else if (options.affinity == AffinityMode::CpuList) {
+            cpu = options.cpus[i % options.cpus.size()];
+        }
+        if (cpu >= 0) {
+            w.cpus.assign(1, cpu);
+            if (nodes > 1) w.node = topology.node_of(cpu);
+        } else if (nodes > 1) {
+            w.node = i % nodes;
+            w.cpus = topology.nodes[w.node];
+        }
+    }
+
+    static constexpr size_t priority_count = 3;
+
+    // One priority class of the global queue: lock-free ring plus a locked
+    // overflow that only sees traffic while the ring is full.
+    struct Lane {
+        explicit Lane(size_t ring_size) : ring(ring_size) {}
+        MpmcRing<Task> ring;
+        std::mutex overflow_mutex;
+        std::deque<Task> overflow;
+        std::atomic<size_t> overflow_size{0};
+
+        bool try_pop(Task& out) {
+            if (ring.try_pop(out)) return true;
+            if (overflow_size.load() == 0) return false;
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            if (overflow.empty()) return false;
+            out = std::move(overflow.front());
+            overflow.pop_front();
+            overflow_size.fetch_sub(1);
+            return true;
+        }
+    };
+
+    // Identifies the pool and slot of the calling thread, if it is a worker.
+    struct WorkerContext {
+        const SimpleThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+    static WorkerContext& current_context() {
+        static thread_local WorkerContext ctx;
+        return ctx;
+    }
+
+    void submit(Task task, TaskPriority priority = TaskPriority::Normal, int node = -1) {
+        submit_bulk(1, [&](size_t) { return std::move(task); }, priority, node);
+    }
+
+    Lane& lane(size_t node, TaskPriority priority) {
+        return *lanes[node * priority_count + static_cast<size_t>(priority)];
+    }
+
+    // Node whose lanes receive a submission with the given hint.
+    size_t target_node(int hint) const {
+        if (nodes == 1) return 0;
+        if (hint >= 0) return static_cast<size_t>(hint) % nodes;
+        const WorkerContext& ctx = current_context();
+        if (ctx.pool == this) return workers[ctx.index]->node;
+        int cpu = current_cpu();
+        return cpu < 0 ? 0 : CpuTopology::instance().node_of(cpu) % nodes;
+    }
+
+    // Queues make_task(0) .. make_task(n - 1), waking up to n workers along
+    // the way. With fail_fast a full queue returns false instead of applying the
+    // overflow policy.
+    template<class MakeTask>
+    bool submit_bulk(size_t n, MakeTask make_task, TaskPriority priority = TaskPriority::Normal, int node = -1,
+                     bool fail_fast = false) {
+        if (n == 0) return true;
+        const auto stamp = metrics.submit_stamp();
+        auto next = [&](size_t i) {
+            Task task = make_task(i);
+            metrics.on_submit(task, stamp);
+            return task;
+        };
+        // Counting before the stop check means a concurrent shutdown either
+        // sees these tasks as pending and waits for them, or we see stop and back
+        // out. Workers may keep submitting while the pool drains.
+        outstanding.fetch_add(n);
+        const Admission admission = admit(n, fail_fast);
+        if (admission == Admission::Rejected) {
+            finished(n);
+            if (fail_fast) return false;
+            throw QueueFullError();
+        }
+        if (admission == Admission::RunInline) {
+            size_t i = 0;
+            try {
+                if (stop) throw std::runtime_error("enqueue on stopped ThreadPool");
+                for (; i < n; ++i) {
+                    Task task = make_task(i);
+                    run(task);
+                    task.reset();
+                    finished(1);
+                }
+            } catch (...) {
+                finished(n - i);
+                throw;
+            }
+            return true;
+        }
+        if (stop && (discarding.load() || current_context().pool != this)) {
+            pending.fetch_sub(n);
+            finished(n);
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+        // Tasks go in a ring's worth at a time, and workers are woken after
+        // each step rather than after the whole batch, so they start on a
+        // large batch while the rest of it is still being built.
+        const size_t step = lanes.front()->ring.capacity();
+        size_t i = 0;
+        try {
+            const WorkerContext& ctx = current_context();
+            if (options.mode == SchedulingMode::WorkStealing && ctx.pool == this
+                && priority == TaskPriority::Normal
+                && (node < 0 || nodes == 1 || static_cast<size_t>(node) % nodes == workers[ctx.index]->node)) {
+                Worker& self = *workers[ctx.index];
+                while (i < n) {
+                    const size_t begin = i, end = std::min(n, i + step);
+                    {
+                        std::lock_guard<std::mutex> lock(self.mutex);
+                        for (; i < end; ++i) self.local.push_back(next(i));
+                    }
+                    if (i < n) wake_idle(i - begin);
+                }
+            } else {
+                Lane& lane = this->lane(target_node(node), priority);
+                while (i < n) {
+                    const size_t begin = i, end = std::min(n, i + step);
+                    for (; i < end; ++i) {
+                        Task task = next(i);
+                        if (lane.overflow_size.load() == 0 && lane.ring.try_push(std::move(task))) continue;
+                        // Ring is full: spill the rest of the step under one lock.
+                        std::lock_guard<std::mutex> lock(lane.overflow_mutex);
+                        lane.overflow.push_back(std::move(task));
+                        lane.overflow_size.fetch_add(1);
+                        for (++i; i < end; ++i) {
+                            lane.overflow.push_back(next(i));
+                            lane.overflow_size.fetch_add(1);
+                        }
+                        break;
+                    }
+                    if (i < n) wake_idle(i - begin);
+                }
+            }
+        } catch (...) {
+            pending.fetch_sub(n - i);
+            finished(n - i);
+            wake_idle(i);
+            throw;
+        }
+        wake_idle(n);
+        if (elastic) watch_backlog();
+        return true;
+    }
+
+    enum class Admission { Queued, Rejected, RunInline };
+
+    // Adds n to pending unless the queue is bounded and full, in which case
+    // the overflow policy decides.
+    Admission admit(size_t n, bool fail_fast) {
+        if (options.max_queued == 0 || current_context().pool == this) {
+            pending.fetch_add(n);
+            return Admission::Queued;
+        }
+        if (try_reserve(n)) return Admission::Queued;
+        if (fail_fast) return Admission::Rejected;
+        switch (options.overflow) {
+        case OverflowPolicy::Reject:
+            return Admission::Rejected;
+        case OverflowPolicy::CallerRuns:
+            return Admission::RunInline;
+        case OverflowPolicy::DropOldest:
+            while (!try_reserve(n)) {
+                // Everything left is already running or in worker deques.
+                if (!drop_oldest()) {
+                    pending.fetch_add(n);
+                    break;
+                }
+            }
+            return Admission::Queued;
+        case OverflowPolicy::Block:
+            break;
+        }
+        std::unique_lock<std::mutex> lock(space_mutex);
+        space_waiters.fetch_add(1);
+        bool reserved = false;
+        space_condition.wait(lock, [&] { return (reserved = try_reserve(n)) || stop; });
+        space_waiters.fetch_sub(1);
+        // Stopping: count the tasks anyway so the caller's stop check backs out.
+        if (!reserved) pending.fetch_add(n);
+        return Admission::Queued;
+    }
+
+    // A batch larger than the whole capacity is let in once the queue is empty.
+    bool try_reserve(size_t n) {
+        size_t p = pending.load();
+        do {
+            if (p != 0 && p + n > options.max_queued) return false;
+        } while (!pending.compare_exchange_weak(p, p + n));
+        return true;
+    }
+
+    // Discards one queued task from the global lanes, Background first.
+    bool drop_oldest() {
+        Task task;
+        for (size_t k = priority_count; k-- > 0;) {
+            for (size_t node = 0; node < nodes; ++node) {
+                if (!lane(node, static_cast<TaskPriority>(k)).try_pop(task)) continue;
+                pending.fetch_sub(1);
+                task.reset();
+                finished(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void notify_space() {
+        // Pairs with the waiter count in admit(), like wake_idle.
+        { std::lock_guard<std::mutex> lock(space_mutex); }
+        space_condition.notify_all();
+    }
+
+    void wake_idle(size_t n) {
+        // Pairs with the idle increment in worker_loop: either the sleeper sees
+        // the new pending count or we see it idle and notify under the mutex.
+        const size_t sleeping = idle.load();
+        if (sleeping == 0 || n == 0) return;
+        { std::lock_guard<std::mutex> lock(queue_mutex); }
+        if (n >= sleeping) {
+            condition.notify_all();
+        } else {
+            while (n--) condition.notify_one();
+        }
+    }
+
+    // Marks n tasks as done (run or dropped) and wakes wait_idle() callers
+    // when none remain.
+    void finished(size_t n) {
+        // Pairs with the waiter count in wait_idle_until, like wake_idle.
+        if (n == 0 || outstanding.fetch_sub(n) != n || idle_waiters.load() == 0) return;
+        { std::lock_guard<std::mutex> lock(idle_mutex); }
+        idle_condition.notify_all();
+    }
+
+    bool wait_idle_until(std::chrono::steady_clock::time_point deadline) {
+        if (current_context().pool == this) throw std::logic_error("wait_idle called from a pool worker");
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        idle_waiters.fetch_add(1);
+        bool idle_now = idle_condition.wait_until(lock, deadline, [this] { return outstanding.load() == 0; });
+        idle_waiters.fetch_sub(1);
+        return idle_now;
+    }
+
+    // Makes workers exit after their current task and cancels stop_token().
+    void begin_discard() {
+        discarding.store(true);
+        stop_source.cancel();
+        { std::lock_guard<std::mutex> lock(queue_mutex); }
+        condition.notify_all();
+    }
+
+    // Destroys every queued task without running it. Only called once the
+    // workers have exited.
+    void discard_queued() {
+        size_t dropped = 0;
+        {
+            Task task;
+            for (auto& lane : lanes)
+                while (lane->try_pop(task)) {
+                    task.reset();
+                    ++dropped;
+                }
+        }
+        for (auto& worker : workers) {
+            std::deque<Task> local;
+            {
+                std::lock_guard<std::mutex> lock(worker->mutex);
+                local.swap(worker->local);
+            }
+            dropped += local.size();
+        }
+        pending.fetch_sub(dropped);
+        finished(dropped);
+    }
+
+    // Caller holds resize_mutex.
+    void start_worker(size_t index) {
+        Worker& w = *workers[index];
+        if (w.thread.joinable()) w.thread.join();   // a retired worker that has exited
+        active.fetch_add(1);
+        w.running.store(true);
+        w.thread = std::thread([this, index] { worker_loop(index); });
+    }
+
+    void worker_loop(size_t index) {
+        current_context() = WorkerContext{this, index};
+        pin_current_thread(workers[index]->cpus);
+        metrics.on_pause(index);   // a restarted worker's last finish is stale
+        for(;;) {
+            if (discarding.load(std::memory_order_relaxed)) return;
+            if (should_retire()) return retire(index);
+            if (timer_due()) {
+                service_timers();
+                metrics.on_pause(index);
+            }
+            Task task;
+            if (find_task(index, task)) {
+                pending.fetch_sub(1);
+                if (space_waiters.load() != 0) notify_space();
+                if (elastic) watch_backlog();
+                auto started = metrics.on_start(index, task);
+                run(task);
+                metrics.on_finish(index, started);
+                task.reset();   // drop captured state before counting the task as done
+                finished(1);
+                continue;
+            }
+            if (elastic) backlog_since.store(0);
+            metrics.on_pause(index);
+            if (spin_for_work()) continue;
+            metrics.on_park(index);
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            idle.fetch_add(1);
+            // With timers pending, one parked worker (the keeper) sleeps only
+            // until the next expiry; the rest sleep until there is work or the
+            // keeper's post is vacant.
+            const int64_t due = timer_deadline.load();
+            const bool keeper = due != no_timer && !timer_keeper.exchange(true);
+            auto ready = [this, keeper, due] {
+                if (stop || pending.load() > 0 || active.load() > target.load()) return true;
+                if (keeper) return timer_deadline.load() < due;
+                return timer_deadline.load() != no_timer && !timer_keeper.load();
+            };
+            bool woke = true;
+            if (keeper || elastic) {
+                const auto now = std::chrono::steady_clock::now();
+                const auto idle_limit = elastic ? now + options.idle_timeout : std::chrono::steady_clock::time_point::max();
+                auto wake_at = idle_limit;
+                if (keeper) wake_at = std::min(wake_at, timer_origin + std::chrono::nanoseconds(due));
+                woke = condition.wait_until(lock, wake_at, ready) || std::chrono::steady_clock::now() < idle_limit;
+            } else {
+                condition.wait(lock, ready);
+            }
+            idle.fetch_sub(1);
+            if (keeper) {
+                timer_keeper.store(false);
+                // Hand the post to another sleeper if we are off to run tasks.
+                if (pending.load() > 0 && idle.load() != 0) condition.notify_one();
+            }
+            if (stop && pending.load() == 0) return;
+            if (!woke) {
+                // Idle for a full timeout: lower the target so one worker retires.
+                size_t t = target.load();
+                while (t > min_active && !target.compare_exchange_weak(t, t - 1)) {}
+            }
+        }
+    }
+
+    struct PeriodicTimer {
+        explicit PeriodicTimer(Task f) : fn(std::move(f)) {}
+        Task fn;
+        std::atomic<bool> running{false};
+    };
+
+    // A one-shot timer owns its task; a periodic one shares it with its runs.
+    struct TimerEntry {
+        Task fn;
+        std::shared_ptr<PeriodicTimer> periodic;
+        uint64_t period = 0;
+    };
+
+    static constexpr int64_t no_timer = std::numeric_limits<int64_t>::max();
+
+    int64_t timer_tick_ns() const {
+        return std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(options.timer_tick).count());
+    }
+
+    int64_t since_origin_ns(std::chrono::steady_clock::time_point t) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t - timer_origin).count();
+    }
+
+    TimerId add_timer(std::chrono::steady_clock::time_point when, uint64_t period, TimerEntry entry) {
+        entry.period = period;
+        const int64_t tick_ns = timer_tick_ns();
+        const int64_t at = std::max<int64_t>(0, since_origin_ns(when));
+        TimerId id;
+        bool earlier;
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            if (stop) throw std::runtime_error("schedule on stopped ThreadPool");
+            const uint64_t tick = std::max(timers.now(), static_cast<uint64_t>((at + tick_ns - 1) / tick_ns));
+            id = timers.schedule(tick, std::move(entry));
+            // The deadline only ever needs to move earlier here, so skip the
+            // wheel scan in update_timer_deadline().
+            const int64_t due = static_cast<int64_t>(tick) * tick_ns;
+            earlier = due < timer_deadline.load();
+            if (earlier) timer_deadline.store(due);
+        }
+        // Wake the timer keeper (or any parked worker) to re-arm its sleep.
+        if (earlier && idle.load() != 0) {
+            { std::lock_guard<std::mutex> lock(queue_mutex); }
+            condition.notify_all();
+        }
+        return id;
+    }
+
+    // Caller holds timer_mutex. Returns whether the deadline moved earlier.
+    bool update_timer_deadline() {
+        const int64_t next = timers.empty() ? no_timer
+                                            : static_cast<int64_t>(timers.next_tick()) * timer_tick_ns();
+        return timer_deadline.exchange(next) > next;
+    }
+
+    bool timer_due() const {
+        const int64_t deadline = timer_deadline.load(std::memory_order_relaxed);
+        return deadline != no_timer && since_origin_ns(std::chrono::steady_clock::now()) >= deadline;
+    }
+
+    // Posts every due callback. Only one worker services the wheel at a time;
+    // the others carry on with tasks.
+    void service_timers() {
+        std::unique_lock<std::mutex> lock(timer_mutex, std::try_to_lock);
+        if (!lock.owns_lock()) return;
+        const uint64_t now_tick = static_cast<uint64_t>(
+            since_origin_ns(std::chrono::steady_clock::now()) / timer_tick_ns());
+        timers.advance(now_tick, [this](TimerId, TimerEntry& e) -> uint64_t {
+            if (!e.periodic) {
+                timer_batch.push_back(std::move(e.fn));
+                return 0;
+            }
+            if (!e.periodic->running.exchange(true)) {
+                timer_batch.emplace_back([p = e.periodic] {
+                    struct Done {
+                        PeriodicTimer& t;
+                        ~Done() { t.running.store(false); }
+                    } done{*p};
+                    p->fn();
+                });
+            }
+            return timers.now() + e.period;
+        });
+        update_timer_deadline();
+        std::vector<Task> batch;
+        batch.swap(timer_batch);
+        lock.unlock();
+        try {
+            post_bulk(std::move(batch));
+        } catch (const std::runtime_error&) {
+            // Discarding shutdown in progress: the callbacks are dropped.
+        }
+    }
+
+    // Drops every pending timer; further schedule calls throw.
+    void close_timers() {
+        TimerWheel<TimerEntry> dropped;
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            std::swap(dropped, timers);
+            timer_deadline.store(no_timer);
+        }
+    }
+
+    // Claims one of the surplus slots if more workers run than requested.
+    bool should_retire() {
+        size_t n = active.load();
+        while (n > target.load()) {
+            if (active.compare_exchange_weak(n, n - 1)) return true;
+        }
+        return false;
+    }
+
+    void retire(size_t index) {
+        Worker& self = *workers[index];
+        std::deque<Task> leftovers;
+        {
+            std::lock_guard<std::mutex> lock(self.mutex);
+            leftovers.swap(self.local);
+        }
+        if (!leftovers.empty()) {
+            // Already counted in pending; hand them to the Normal lane as-is.
+            Lane& lane = this->lane(self.node, TaskPriority::Normal);
+            std::lock_guard<std::mutex> lock(lane.overflow_mutex);
+            for (auto& t : leftovers) lane.overflow.push_back(std::move(t));
+            lane.overflow_size.fetch_add(leftovers.size());
+        }
+        wake_idle(leftovers.size());
+        self.running.store(false);
+    }
+
+    // Elastic growth: tasks have waited with no idle worker for grow_after.
+    void watch_backlog() {
+        if (idle.load() != 0 || pending.load() == 0) {
+            if (backlog_since.load(std::memory_order_relaxed) != 0) backlog_since.store(0);
+            return;
+        }
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t since = backlog_since.load();
+        if (since == 0) {
+            backlog_since.compare_exchange_strong(since, now);
+            return;
+        }
+        if (now - since < std::chrono::duration_cast<std::chrono::nanoseconds>(options.grow_after).count()) return;
+        if (!backlog_since.compare_exchange_strong(since, now)) return;
+        std::unique_lock<std::mutex> lock(resize_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || stop || target.load() >= options.max_threads) return;
+        for (size_t i = 0; i < workers.size(); ++i) {
+            if (!workers[i]->running.load()) {
+                target.fetch_add(1);
+                start_worker(i);
+                return;
+            }
+        }
+    }
+
+    void run(Task& task) {
+        try {
+            task();
+        } catch (...) {
+            report_error(std::current_exception());
+        }
+    }
+
+    void report_error(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(handler_mutex);
+        if (error_handler) error_handler(error);
+    }
+
+    bool find_task(size_t index, Task& out) {
+        if (options.mode == SchedulingMode::SharedQueue) return pop_global(index, out);
+        return pop_local(index, out) || pop_global(index, out) || steal(index, out);
+    }
+
+    // Also ends as soon as a timer falls due: with more threads than cores a
+    // yield can take a whole scheduler slice, so spinning on regardless would
+    // hold due callbacks back by spin_count slices.
+    bool spin_for_work() const {
+        for (unsigned i = 0; i < options.spin_count; ++i) {
+            if (pending.load(std::memory_order_relaxed) > 0 || timer_due()) return true;
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    bool pop_local(size_t index, Task& out) {
+        Worker& self = *workers[index];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (self.local.empty()) return false;
+        out = std::move(self.local.back());
+        self.local.pop_back();
+        return true;
+    }
+
+    bool pop_global(size_t index, Task& out) {
+        Worker& self = *workers[index];
+        const unsigned interval = options.starvation_interval;
+        const bool lowest_first = interval != 0 && self.global_pops % interval == interval - 1;
+        for (size_t k = 0; k < priority_count; ++k) {
+            auto p = static_cast<TaskPriority>(lowest_first ? priority_count - 1 - k : k);
+            // Own node first, then the others so no hinted task is stranded.
+            for (size_t d = 0; d < nodes; ++d) {
+                if (lane((self.node + d) % nodes, p).try_pop(out)) {
+                    ++self.global_pops;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool steal(size_t index, Task& out) {
+        const size_t n = workers.size();
+        if (n < 2) return false;
+        uint64_t& s = workers[index]->rng_state;
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        const size_t start = static_cast<size_t>(s % n);
+        for (size_t k = 0; k < n; ++k) {
+            size_t victim = (start + k) % n;
+            if (victim == index) continue;
+            Worker& w = *workers[victim];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (w.local.empty()) continue;
+            out = std::move(w.local.front());
+            w.local.pop_front();
+            metrics.on_steal(index);
+            return true;
+        }
+        return false;
+    }
+
+    ThreadPoolOptions options;
+    Metrics metrics;
+    std::shared_ptr<SlabPool> slab = std::make_shared<SlabPool>();
+    std::vector<std::unique_ptr<Worker>> workers;
+    size_t nodes = 1;
+    std::vector<std::unique_ptr<Lane>> lanes;   // priority_count per node
     std::mutex queue_mutex;
     std::condition_variable condition;
-    bool stop;
+    std::mutex handler_mutex;
+    std::function<void(std::exception_ptr)> error_handler;
+    std::atomic<bool> stop;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> idle{0};
+    bool elastic = false;
+    size_t min_active = 1;
+    std::mutex resize_mutex;
+    std::atomic<size_t> active{0};
+    std::atomic<size_t> target{0};
+    std::atomic<int64_t> backlog_since{0};
+    std::atomic<size_t> outstanding{0};   // submitted and not yet finished or dropped
+    std::atomic<size_t> idle_waiters{0};
+    std::mutex idle_mutex;
+    std::condition_variable idle_condition;
+    std::atomic<bool> discarding{false};
+    CancellationSource stop_source;
+    std::mutex shutdown_mutex;
+    bool shut_down = false;
+    std::atomic<size_t> space_waiters{0};
+    std::mutex space_mutex;
+    std::condition_variable space_condition;
+    std::chrono::steady_clock::time_point timer_origin = std::chrono::steady_clock::now();
+    std::mutex timer_mutex;
+    TimerWheel<TimerEntry> timers;
+    std::vector<Task> timer_batch;
+    std::atomic<int64_t> timer_deadline{no_timer};   // ns since timer_origin
+    std::atomic<bool> timer_keeper{false};
 };
 
 #endif
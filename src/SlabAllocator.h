@@ -0,0 +1,127 @@
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+// Thread-safe free-list allocator for small fixed-size blocks. Blocks are
+// carved out of 64-block chunks per size class and recycled on release, so
+// once warmed up a steady allocate/deallocate pattern never reaches malloc.
+// Requests larger than the biggest class go straight to operator new.
+class SlabPool {
+public:
+    static constexpr size_t class_count = 4;           // 64, 128, 256, 512 bytes
+    static constexpr size_t min_block = 64;
+    static constexpr size_t max_block = min_block << (class_count - 1);
+    static constexpr size_t blocks_per_chunk = 64;
+
+    SlabPool() = default;
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    void* allocate(size_t bytes) {
+        if (bytes > max_block) return ::operator new(bytes);
+        SizeClass& sc = classes[class_index(bytes)];
+        {
+            SpinGuard guard(sc.lock);
+            if (FreeNode* node = sc.free) {
+                sc.free = node->next;
+                return node;
+            }
+        }
+        return grow(sc, block_size(class_index(bytes)));
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (bytes > max_block) {
+            ::operator delete(p);
+            return;
+        }
+        SizeClass& sc = classes[class_index(bytes)];
+        FreeNode* node = static_cast<FreeNode*>(p);
+        SpinGuard guard(sc.lock);
+        node->next = sc.free;
+        sc.free = node;
+    }
+
+private:
+    struct FreeNode { FreeNode* next; };
+
+    struct alignas(64) SizeClass {
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        FreeNode* free = nullptr;
+    };
+
+    struct SpinGuard {
+        explicit SpinGuard(std::atomic_flag& f) : flag(f) {
+            while (flag.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+        }
+        ~SpinGuard() { flag.clear(std::memory_order_release); }
+        std::atomic_flag& flag;
+    };
+
+    static size_t class_index(size_t bytes) {
+        size_t idx = 0, size = min_block;
+        while (size < bytes) { size <<= 1; ++idx; }
+        return idx;
+    }
+    static size_t block_size(size_t idx) { return min_block << idx; }
+
+    void* grow(SizeClass& sc, size_t size) {
+        unsigned char* chunk;
+        {
+            std::lock_guard<std::mutex> lock(chunk_mutex);
+            chunks.emplace_back(new unsigned char[size * blocks_per_chunk]);
+            chunk = chunks.back().get();
+        }
+        // Keep the first block for the caller and publish the rest.
+        FreeNode* head = nullptr;
+        for (size_t i = blocks_per_chunk - 1; i >= 1; --i) {
+            FreeNode* node = reinterpret_cast<FreeNode*>(chunk + i * size);
+            node->next = head;
+            head = node;
+        }
+        FreeNode* tail = reinterpret_cast<FreeNode*>(chunk + (blocks_per_chunk - 1) * size);
+        SpinGuard guard(sc.lock);
+        tail->next = sc.free;
+        sc.free = head;
+        return chunk;
+    }
+
+    SizeClass classes[class_count];
+    std::mutex chunk_mutex;
+    std::vector<std::unique_ptr<unsigned char[]>> chunks;
+};
+
+// Standard allocator over a shared SlabPool. Copies keep the pool alive, so
+// objects allocated through it (e.g. future shared states) may outlive the
+// component that created the pool.
+template<class T>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    explicit SlabAllocator(std::shared_ptr<SlabPool> p) noexcept : pool(std::move(p)) {}
+    template<class U>
+    SlabAllocator(const SlabAllocator<U>& other) noexcept : pool(other.pool) {}
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+        return static_cast<T*>(pool->allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept { pool->deallocate(p, n * sizeof(T)); }
+
+    template<class U>
+    bool operator==(const SlabAllocator<U>& other) const noexcept { return pool == other.pool; }
+    template<class U>
+    bool operator!=(const SlabAllocator<U>& other) const noexcept { return pool != other.pool; }
+
+    std::shared_ptr<SlabPool> pool;
+};
+
+#endif
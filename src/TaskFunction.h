@@ -0,0 +1,106 @@
+#ifndef TASK_FUNCTION_H
+#define TASK_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Move-only `void()` callable with small-buffer storage. Callables that fit
+// in `inline_size` bytes (and are nothrow-movable) live inside the object, so
+// wrapping a small lambda never allocates; larger ones fall back to the heap.
+class TaskFunction {
+public:
+    static constexpr size_t inline_size = 64;
+
+    TaskFunction() noexcept = default;
+
+    template<class F, class = typename std::enable_if<
+        !std::is_same<typename std::decay<F>::type, TaskFunction>::value>::type>
+    TaskFunction(F&& f) {
+        using Fn = typename std::decay<F>::type;
+        if constexpr (fits_inline<Fn>()) {
+            ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+            ops = &inline_ops<Fn>;
+        } else {
+            *reinterpret_cast<Fn**>(storage) = new Fn(std::forward<F>(f));
+            ops = &heap_ops<Fn>;
+        }
+    }
+
+    TaskFunction(TaskFunction&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    TaskFunction& operator=(TaskFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) {
+                other.ops->move(storage, other.storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    TaskFunction(const TaskFunction&) = delete;
+    TaskFunction& operator=(const TaskFunction&) = delete;
+
+    ~TaskFunction() { reset(); }
+
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+    void operator()() { ops->invoke(storage); }
+
+    void reset() noexcept {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    template<class Fn>
+    static constexpr bool fits_inline() {
+        return sizeof(Fn) <= inline_size && alignof(Fn) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible<Fn>::value;
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* dst, void* src) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<class Fn>
+    static Fn* inline_ptr(void* p) { return std::launder(static_cast<Fn*>(p)); }
+
+    template<class Fn>
+    static Fn*& heap_ptr(void* p) { return *static_cast<Fn**>(p); }
+
+    template<class Fn>
+    static constexpr Ops inline_ops = {
+        [](void* p) { (*inline_ptr<Fn>(p))(); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*inline_ptr<Fn>(src)));
+            inline_ptr<Fn>(src)->~Fn();
+        },
+        [](void* p) noexcept { inline_ptr<Fn>(p)->~Fn(); },
+    };
+
+    template<class Fn>
+    static constexpr Ops heap_ops = {
+        [](void* p) { (*heap_ptr<Fn>(p))(); },
+        [](void* dst, void* src) noexcept { *static_cast<Fn**>(dst) = heap_ptr<Fn>(src); },
+        [](void* p) noexcept { delete heap_ptr<Fn>(p); },
+    };
+
+    alignas(std::max_align_t) unsigned char storage[inline_size];
+    const Ops* ops = nullptr;
+};
+
+#endif
@@ -0,0 +1,279 @@
+#ifndef THREAD_POOL_METRICS_H
+#define THREAD_POOL_METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "TaskFunction.h"
+
+// Instrumentation for SimpleThreadPool. The pool only records into
+// ThreadPoolMetrics when built with SIMPLE_THREAD_POOL_METRICS defined;
+// otherwise it uses NullThreadPoolMetrics, whose hooks are empty inline
+// functions, and tasks carry no timestamp.
+//
+// Every worker owns its counters, histograms and trace buffer, so recording
+// is a handful of relaxed single-writer stores with no shared cache lines.
+// Snapshots and traces read them concurrently without stopping the pool.
+//
+// Clock reads dominate the cost, so there are as few as possible: a worker
+// running tasks back to back reads the clock once per task, reusing each
+// finish time as the next start, and queue wait is sampled, with one read
+// per sampled submit call (a bulk submit shares it among all its tasks).
+
+// Log-linear histogram in the style of HdrHistogram: 16 sub-buckets per power
+// of two, so every recorded value is within about 6% of its bucket's bounds.
+// Values are nanoseconds but nothing here depends on the unit.
+struct HistogramSnapshot {
+    static constexpr unsigned sub_bits = 4;
+    static constexpr size_t sub_count = size_t(1) << sub_bits;
+    static constexpr size_t bucket_count = (64 - sub_bits + 1) * sub_count;
+
+    std::vector<uint64_t> counts = std::vector<uint64_t>(bucket_count, 0);
+    uint64_t total = 0;
+    uint64_t sum = 0;
+
+    static size_t bucket_of(uint64_t v) {
+        if (v < sub_count) return static_cast<size_t>(v);
+        unsigned e = 63 - static_cast<unsigned>(__builtin_clzll(v));
+        return (e - sub_bits + 1) * sub_count + ((v >> (e - sub_bits)) & (sub_count - 1));
+    }
+
+    static uint64_t lower_bound(size_t bucket) {
+        if (bucket < sub_count) return bucket;
+        unsigned e = static_cast<unsigned>(bucket / sub_count) + sub_bits - 1;
+        return (sub_count + bucket % sub_count) << (e - sub_bits);
+    }
+
+    uint64_t count() const { return total; }
+    double mean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+    // Lower bound of the bucket holding the p-th percentile (0..100).
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * (total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < bucket_count; ++b) {
+            seen += counts[b];
+            if (seen >= rank) return lower_bound(b);
+        }
+        return lower_bound(bucket_count - 1);
+    }
+
+    void merge(const HistogramSnapshot& other) {
+        for (size_t b = 0; b < bucket_count; ++b) counts[b] += other.counts[b];
+        total += other.total;
+        sum += other.sum;
+    }
+};
+
+class ThreadPoolMetrics {
+public:
+    // Task as stored in the pool's queues: the callable plus the time it was
+    // queued, for queue-wait accounting (no_time when not sampled).
+    class Task : public TaskFunction {
+    public:
+        Task() noexcept = default;
+        Task(TaskFunction&& fn) noexcept : TaskFunction(std::move(fn)) {}
+        template<class F, class = typename std::enable_if<
+            !std::is_base_of<TaskFunction, typename std::decay<F>::type>::value>::type>
+        Task(F&& f) : TaskFunction(std::forward<F>(f)) {}
+
+        int64_t queued_at = no_time;
+    };
+
+    struct WorkerStats {
+        uint64_t tasks = 0;
+        uint64_t busy_ns = 0;
+        uint64_t steals = 0;
+        uint64_t parks = 0;
+    };
+
+    struct Snapshot {
+        std::vector<WorkerStats> workers;   // one per worker slot
+        size_t queue_depth = 0;             // tasks queued but not started
+        uint64_t uptime_ns = 0;
+        HistogramSnapshot queue_wait;       // submit to start, 1 in queue_wait_sample submits
+        HistogramSnapshot run_time;         // start to finish
+
+        uint64_t tasks() const {
+            uint64_t n = 0;
+            for (const auto& w : workers) n += w.tasks;
+            return n;
+        }
+
+        // Fraction of worker-time spent running tasks since the pool started.
+        double utilization(size_t running_workers) const {
+            if (uptime_ns == 0 || running_workers == 0) return 0.0;
+            uint64_t busy = 0;
+            for (const auto& w : workers) busy += w.busy_ns;
+            return static_cast<double>(busy) / (static_cast<double>(uptime_ns) * running_workers);
+        }
+    };
+
+    // trace_events: task start/stop pairs kept per worker for
+    // write_chrome_trace(); recording stops once a worker's buffer is full.
+    ThreadPoolMetrics(size_t workers, size_t trace_events) : origin(std::chrono::steady_clock::now()) {
+        for (size_t i = 0; i < workers; ++i) per_worker.emplace_back(new PerWorker(trace_events));
+    }
+
+    // Submit calls per submitting thread whose tasks get a queue-wait sample.
+    static constexpr unsigned queue_wait_sample = 16;
+
+    // Called once per submit call; the result is passed to on_submit() for
+    // each of its tasks.
+    int64_t submit_stamp() const {
+        thread_local unsigned calls = 0;
+        return calls++ % queue_wait_sample == 0 ? now() : no_time;
+    }
+
+    void on_submit(Task& task, int64_t stamp) const { task.queued_at = stamp; }
+
+    int64_t on_start(size_t worker, const Task& task) {
+        PerWorker& w = *per_worker[worker];
+        const int64_t start = w.last_end != no_time ? w.last_end : now();
+        if (task.queued_at != no_time)
+            w.queue_wait.record(static_cast<uint64_t>(std::max<int64_t>(0, start - task.queued_at)));
+        return start;
+    }
+
+    // The worker did something other than go straight to its next task
+    // (looked for work and found none, or serviced timers), so that task's
+    // start needs a clock read of its own.
+    void on_pause(size_t worker) { per_worker[worker]->last_end = no_time; }
+
+    void on_finish(size_t worker, int64_t start) {
+        PerWorker& w = *per_worker[worker];
+        const int64_t end = now();
+        w.last_end = end;
+        uint64_t ran = static_cast<uint64_t>(end - start);
+        w.run_time.record(ran);
+        bump(w.tasks, 1);
+        bump(w.busy_ns, ran);
+        size_t n = w.trace_size.load(std::memory_order_relaxed);
+        if (n < w.trace_capacity) {
+            w.trace[n] = TraceEvent{start, end};
+            w.trace_size.store(n + 1, std::memory_order_release);
+        }
+    }
+
+    void on_steal(size_t worker) { bump(per_worker[worker]->steals, 1); }
+    void on_park(size_t worker) { bump(per_worker[worker]->parks, 1); }
+
+    Snapshot snapshot(size_t queue_depth) const {
+        Snapshot s;
+        s.queue_depth = queue_depth;
+        s.uptime_ns = static_cast<uint64_t>(now());
+        for (const auto& w : per_worker) {
+            WorkerStats stats;
+            stats.tasks = w->tasks.load(std::memory_order_relaxed);
+            stats.busy_ns = w->busy_ns.load(std::memory_order_relaxed);
+            stats.steals = w->steals.load(std::memory_order_relaxed);
+            stats.parks = w->parks.load(std::memory_order_relaxed);
+            s.workers.push_back(stats);
+            w->queue_wait.read_into(s.queue_wait);
+            w->run_time.read_into(s.run_time);
+        }
+        return s;
+    }
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto): one complete
+    // ("X") event per traced task, one track per worker.
+    void write_chrome_trace(std::ostream& out) const {
+        out << "{\"traceEvents\":[";
+        bool first = true;
+        for (size_t i = 0; i < per_worker.size(); ++i) {
+            const PerWorker& w = *per_worker[i];
+            out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+                << ",\"args\":{\"name\":\"worker " << i << "\"}}";
+            first = false;
+            size_t n = w.trace_size.load(std::memory_order_acquire);
+            for (size_t k = 0; k < n; ++k) {
+                out << ",\n{\"name\":\"task\",\"ph\":\"X\",\"pid\":1,\"tid\":" << i
+                    << ",\"ts\":" << w.trace[k].start / 1000.0
+                    << ",\"dur\":" << (w.trace[k].end - w.trace[k].start) / 1000.0 << "}";
+            }
+        }
+        out << "\n]}\n";
+    }
+
+private:
+    static constexpr int64_t no_time = -1;
+
+    // Single writer (the owning worker); readers may race and see a slightly
+    // stale total, never a torn one.
+    static void bump(std::atomic<uint64_t>& c, uint64_t n) {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    class Histogram {
+    public:
+        Histogram() : counts(new std::atomic<uint64_t>[HistogramSnapshot::bucket_count]) {
+            for (size_t b = 0; b < HistogramSnapshot::bucket_count; ++b) counts[b].store(0, std::memory_order_relaxed);
+        }
+
+        void record(uint64_t v) {
+            bump(counts[HistogramSnapshot::bucket_of(v)], 1);
+            bump(total, 1);
+            bump(sum, v);
+        }
+
+        void read_into(HistogramSnapshot& out) const {
+            for (size_t b = 0; b < HistogramSnapshot::bucket_count; ++b)
+                out.counts[b] += counts[b].load(std::memory_order_relaxed);
+            out.total += total.load(std::memory_order_relaxed);
+            out.sum += sum.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> counts;
+        std::atomic<uint64_t> total{0};
+        std::atomic<uint64_t> sum{0};
+    };
+
+    struct TraceEvent { int64_t start, end; };
+
+    struct alignas(64) PerWorker {
+        explicit PerWorker(size_t trace_events)
+            : trace(new TraceEvent[trace_events]), trace_capacity(trace_events) {}
+        std::atomic<uint64_t> tasks{0};
+        std::atomic<uint64_t> busy_ns{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> parks{0};
+        Histogram queue_wait;
+        Histogram run_time;
+        std::unique_ptr<TraceEvent[]> trace;
+        const size_t trace_capacity;
+        std::atomic<size_t> trace_size{0};
+        int64_t last_end = no_time;   // owner only: finish time of the task just run
+    };
+
+    // Nanoseconds since the metrics were created.
+    int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    std::chrono::steady_clock::time_point origin;
+    std::vector<std::unique_ptr<PerWorker>> per_worker;
+};
+
+// Stand-in used when metrics are compiled out.
+struct NullThreadPoolMetrics {
+    using Task = TaskFunction;
+    NullThreadPoolMetrics(size_t, size_t) {}
+    int submit_stamp() const { return 0; }
+    void on_submit(Task&, int) const {}
+    int on_start(size_t, const Task&) { return 0; }
+    void on_pause(size_t) {}
+    void on_finish(size_t, int) {}
+    void on_steal(size_t) {}
+    void on_park(size_t) {}
+};
+
+#endif
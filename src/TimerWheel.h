@@ -0,0 +1,207 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Hierarchical timing wheel (Varghese & Lauck) over an integer tick count.
+// Four levels of 256 slots cover 2^32 ticks ahead of the current tick; later
+// timers wait on a far list that is re-sorted whenever the top level wraps.
+// A timer sits in the level whose digit is the highest one in which its
+// expiry differs from the current tick, and moves down a level each time the
+// wheel reaches its slot, so schedule and cancel are O(1) list operations and
+// advance() does one move per timer per level, jumping over empty stretches.
+//
+// Timers live in a node array indexed by 32-bit links and recycled through a
+// free list; an Id packs the node index with a generation count, so stale Ids
+// are rejected by cancel(). Not thread-safe.
+template<class T>
+class TimerWheel {
+public:
+    using Id = uint64_t;   // 0 is never a valid Id
+
+    static constexpr unsigned slot_bits = 8;
+    static constexpr uint32_t slots = 1u << slot_bits;
+    static constexpr unsigned levels = 4;
+
+    explicit TimerWheel(uint64_t start_tick = 0) : current(start_tick) {
+        heads.assign(list_count, nil);
+    }
+
+    uint64_t now() const { return current; }
+    size_t size() const { return live; }
+    bool empty() const { return live == 0; }
+
+    // Expiries at or before now() fire on the next advance().
+    Id schedule(uint64_t tick, T value) {
+        uint32_t index;
+        if (free_head != nil) {
+            index = free_head;
+            free_head = nodes[index].next;
+        } else {
+            index = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        Node& n = nodes[index];
+        n.tick = tick;
+        n.value.emplace(std::move(value));
+        link(index);
+        ++live;
+        return make_id(index, n.generation);
+    }
+
+    // False if the timer already fired, was cancelled, or the Id is stale.
+    bool cancel(Id id) {
+        uint32_t index = static_cast<uint32_t>(id & 0xffffffffu) - 1;
+        uint32_t generation = static_cast<uint32_t>(id >> 32);
+        if (id == 0 || index >= nodes.size()) return false;
+        Node& n = nodes[index];
+        if (n.generation != generation || !n.value) return false;
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // Next tick at which the wheel has work: the exact expiry for timers on
+    // the lowest level, otherwise the tick at which the earliest occupied
+    // higher-level slot cascades. Scans at most one level's worth of slots per
+    // level. Meaningless when empty().
+    uint64_t next_tick() const {
+        if (heads[due_list] != nil) return current;
+        for (unsigned l = 0; l < levels; ++l) {
+            const unsigned shift = slot_bits * l;
+            for (uint32_t d = digit(current, l) + 1; d < slots; ++d) {
+                if (heads[l * slots + d] == nil) continue;
+                return ((current >> (shift + slot_bits)) << (shift + slot_bits)) | (uint64_t(d) << shift);
+            }
+        }
+        return ((current >> (slot_bits * levels)) + 1) << (slot_bits * levels);
+    }
+
+    // Moves time forward to `target`, calling fire(id, value) for every timer
+    // that expires, in tick order. fire returns 0 to retire the timer or a
+    // tick after now() at which to fire it again (keeping its Id); it must not
+    // schedule or cancel timers itself.
+    template<class Fire>
+    void advance(uint64_t target, Fire&& fire) {
+        fire_list(due_list, fire);
+        while (current < target) {
+            // Skip straight to the next tick with work; nothing in between
+            // needs cascading.
+            const uint64_t next = live == 0 ? target : next_tick();
+            if (next > target) {
+                current = target;
+                break;
+            }
+            current = next;
+            for (unsigned l = levels; l-- > 1;) {
+                if ((current & ((uint64_t(1) << (slot_bits * l)) - 1)) != 0) continue;
+                if (l == levels - 1) cascade(far_list);
+                cascade(l * slots + digit(current, l));
+            }
+            fire_list(digit(current, 0), fire);
+            fire_list(due_list, fire);
+        }
+    }
+
+private:
+    static constexpr uint32_t nil = 0xffffffffu;
+    static constexpr uint32_t due_list = levels * slots;
+    static constexpr uint32_t far_list = due_list + 1;
+    static constexpr uint32_t list_count = far_list + 1;
+
+    struct Node {
+        uint64_t tick = 0;
+        uint32_t prev = nil;
+        uint32_t next = nil;
+        uint32_t list = nil;
+        uint32_t generation = 1;
+        std::optional<T> value;
+    };
+
+    static uint32_t digit(uint64_t tick, unsigned level) {
+        return static_cast<uint32_t>(tick >> (slot_bits * level)) & (slots - 1);
+    }
+
+    static Id make_id(uint32_t index, uint32_t generation) {
+        return (uint64_t(generation) << 32) | (uint64_t(index) + 1);
+    }
+
+    uint32_t list_for(uint64_t tick) const {
+        if (tick <= current) return due_list;
+        for (unsigned l = 0; l < levels; ++l)
+            if ((tick >> (slot_bits * (l + 1))) == (current >> (slot_bits * (l + 1))))
+                return l * slots + digit(tick, l);
+        return far_list;
+    }
+
+    void link(uint32_t index) {
+        Node& n = nodes[index];
+        n.list = list_for(n.tick);
+        n.prev = nil;
+        n.next = heads[n.list];
+        if (n.next != nil) nodes[n.next].prev = index;
+        heads[n.list] = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& n = nodes[index];
+        if (n.prev != nil) nodes[n.prev].next = n.next;
+        else heads[n.list] = n.next;
+        if (n.next != nil) nodes[n.next].prev = n.prev;
+        n.prev = n.next = n.list = nil;
+    }
+
+    void release(uint32_t index) {
+        Node& n = nodes[index];
+        n.value.reset();
+        ++n.generation;
+        if (n.generation == 0) n.generation = 1;
+        n.next = free_head;
+        free_head = index;
+        --live;
+    }
+
+    // Re-files every timer on `list` relative to the new current tick.
+    void cascade(uint32_t list) {
+        uint32_t index = heads[list];
+        heads[list] = nil;
+        while (index != nil) {
+            uint32_t next = nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    template<class Fire>
+    void fire_list(uint32_t list, Fire& fire) {
+        // Detach first: fire() may schedule new timers, including onto this list.
+        uint32_t index = heads[list];
+        heads[list] = nil;
+        while (index != nil) {
+            uint32_t next = nodes[index].next;
+            Node& n = nodes[index];
+            n.list = nil;
+            uint64_t again = fire(make_id(index, n.generation), *n.value);
+            Node& after = nodes[index];   // fire() may have grown the node array
+            if (again != 0) {
+                after.tick = again;
+                link(index);
+            } else {
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    uint64_t current;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> heads;
+    uint32_t free_head = nil;
+    size_t live = 0;
+};
+
+#endif
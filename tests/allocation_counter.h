@@ -0,0 +1,31 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+// Counts heap allocations made by the current thread while an
+// AllocationScope is alive. This replaces the global operator new and
+// delete, so include it from one translation unit per test executable.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local bool tracking = false;
+thread_local size_t allocations = 0;
+
+struct AllocationScope {
+    AllocationScope() { allocations = 0; tracking = true; }
+    ~AllocationScope() { tracking = false; }
+    size_t count() const { return allocations; }
+};
+}
+
+void* operator new(size_t size) {
+    if (tracking) ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+#endif
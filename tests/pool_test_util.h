@@ -0,0 +1,24 @@
+#ifndef POOL_TEST_UTIL_H
+#define POOL_TEST_UTIL_H
+
+#include "SimpleThreadPool.h"
+
+#include <future>
+
+// Holds one of the pool's workers (its only one, in the tests that use it)
+// until release(), so later submissions stay queued.
+struct Blocker {
+    explicit Blocker(SimpleThreadPool& pool) {
+        std::promise<void> started;
+        auto started_future = started.get_future();
+        pool.post([this, &started] {
+            started.set_value();
+            gate.get_future().wait();
+        });
+        started_future.wait();
+    }
+    void release() { gate.set_value(); }
+    std::promise<void> gate;
+};
+
+#endif
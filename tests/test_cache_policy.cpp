@@ -0,0 +1,119 @@
+#include "CachePolicy.h"
+#include "LRUCache.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+// Read-through replay; returns hits.
+template<class Cache>
+size_t replay(Cache& cache, const std::vector<int>& trace) {
+    size_t hits = 0;
+    for (int k : trace) {
+        if (cache.try_get(k)) ++hits;
+        else cache.put(k, k);
+    }
+    return hits;
+}
+
+// Hot keys 0..hot-1 drawn at random, interrupted by sequential scans over
+// keys that are never seen again.
+std::vector<int> hot_set_with_scans(int hot, int rounds, int scan_length) {
+    std::mt19937 rng(5);
+    std::vector<int> trace;
+    int cold = 1000000;
+    for (int r = 0; r < rounds; ++r) {
+        for (int i = 0; i < hot * 4; ++i) trace.push_back(static_cast<int>(rng() % hot));
+        for (int i = 0; i < scan_length; ++i) trace.push_back(cold++);
+    }
+    return trace;
+}
+}
+
+// The sketch counts up to 15, tells frequent hashes from rare ones and ages
+TEST(FrequencySketchTest, CountsSaturatesAndAges) {
+    FrequencySketch sketch(64);
+    for (int i = 0; i < 5; ++i) sketch.increment(1);
+    EXPECT_EQ(sketch.frequency(1), 5);
+    EXPECT_EQ(sketch.frequency(2), 0);
+    for (int i = 0; i < 100; ++i) sketch.increment(3);
+    EXPECT_EQ(sketch.frequency(3), FrequencySketch::max_count);
+    // The 640th counted increment halves every counter.
+    for (int i = 0; i < 640; ++i) sketch.increment(static_cast<size_t>(1000 + i));
+    EXPECT_LE(sketch.frequency(3), 8);
+}
+
+// The default policy is plain LRU
+TEST(CachePolicyTest, LruPolicyIsDefault) {
+    static_assert(std::is_same<IntLRUCache::policy_type, LruPolicy>::value, "LRU by default");
+    LRUCache<int, int, std::hash<int>, std::equal_to<int>, std::allocator<std::pair<const int, int>>, LruPolicy>
+        cache(2);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.get(1);
+    cache.put(3, 3);
+    EXPECT_EQ(cache.try_get(2), nullptr);
+}
+
+// TinyLFU behaves as a cache: hits return the latest value, size stays bounded
+TEST(CachePolicyTest, TinyLfuBasicOperations) {
+    TinyLfuCache<int, int> cache(100);
+    for (int k = 0; k < 1000; ++k) cache.put(k, k * 2);
+    EXPECT_EQ(cache.size(), 100u);
+    size_t present = 0;
+    for (int k = 0; k < 1000; ++k)
+        if (const int* v = cache.peek(k)) {
+            EXPECT_EQ(*v, k * 2);
+            ++present;
+        }
+    EXPECT_EQ(present, 100u);
+    // Admission only filters what leaves the window; a key just written is
+    // always in the window, whether it was overwritten or newly added.
+    cache.put(999, 1);
+    ASSERT_NE(cache.peek(999), nullptr);
+    EXPECT_EQ(*cache.peek(999), 1);
+    cache.put(5000, 7);
+    ASSERT_NE(cache.peek(5000), nullptr);
+    EXPECT_EQ(*cache.peek(5000), 7);
+}
+
+// Tiny capacities still work (window of one, empty protected segment)
+TEST(CachePolicyTest, TinyLfuTinyCapacities) {
+    for (size_t capacity : {1, 2, 3}) {
+        TinyLfuCache<int, int> cache(capacity);
+        std::mt19937 rng(static_cast<unsigned>(capacity));
+        for (int i = 0; i < 10000; ++i) {
+            int k = static_cast<int>(rng() % 10);
+            if (!cache.try_get(k)) cache.put(k, k);
+            ASSERT_LE(cache.size(), capacity);
+        }
+    }
+}
+
+// A scan over cold keys does not flush the hot set under TinyLFU
+TEST(CachePolicyTest, TinyLfuResistsScans) {
+    const auto trace = hot_set_with_scans(200, 20, 2000);
+    IntLRUCache lru(400);
+    TinyLfuCache<int, int> tiny(400);
+    size_t lru_hits = replay(lru, trace);
+    size_t tiny_hits = replay(tiny, trace);
+    EXPECT_GT(tiny_hits, lru_hits + lru_hits / 10);
+    // Right after a scan the hot keys are still there.
+    size_t hot_present = 0;
+    for (int k = 0; k < 200; ++k) hot_present += tiny.peek(k) != nullptr;
+    EXPECT_GT(hot_present, 180u);
+}
+
+// Copies keep every entry and the segment each one was in
+TEST(CachePolicyTest, TinyLfuCopy) {
+    TinyLfuCache<int, int> a(50);
+    const auto trace = hot_set_with_scans(30, 3, 100);
+    replay(a, trace);
+    TinyLfuCache<int, int> b(a);
+    EXPECT_EQ(b.size(), a.size());
+    for (int k = 0; k < 30; ++k) EXPECT_EQ(b.peek(k) != nullptr, a.peek(k) != nullptr);
+    // Both evolve identically from here.
+    EXPECT_EQ(replay(a, trace), replay(b, trace));
+}
@@ -0,0 +1,272 @@
+#include "CacheSnapshot.h"
+#include "LRUCache.h"
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+// Fresh path per test, removed afterwards.
+class SnapshotFile {
+public:
+    explicit SnapshotFile(const char* name)
+        : path(::testing::TempDir() + "lru_snapshot_" + std::to_string(::getpid()) + "_" + name) {}
+    ~SnapshotFile() { std::remove(path.c_str()); }
+
+    std::string bytes() const {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void overwrite(const std::string& data) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    const std::string path;
+};
+
+template<class Cache>
+std::vector<std::pair<typename Cache::key_type, typename Cache::mapped_type>> contents(const Cache& cache) {
+    std::vector<std::pair<typename Cache::key_type, typename Cache::mapped_type>> out;
+    cache.for_each([&](const auto& k, const auto& v) { out.emplace_back(k, v); });
+    return out;
+}
+
+using Entries = std::vector<std::pair<int, int>>;
+
+// Weighs a string value by its length.
+struct ValueLength {
+    size_t operator()(int, const std::string& v) const { return v.size(); }
+};
+}
+
+// for_each visits entries least recently used first and changes nothing
+TEST(CacheSnapshotTest, ForEachIsColdestFirst) {
+    IntLRUCache cache(4);
+    for (int k = 1; k <= 4; ++k) cache.put(k, k * 10);
+    cache.get(2);
+    EXPECT_EQ(contents(cache), (Entries{{1, 10}, {3, 30}, {4, 40}, {2, 20}}));
+    EXPECT_EQ(contents(cache), (Entries{{1, 10}, {3, 30}, {4, 40}, {2, 20}}));
+}
+
+// Save then load restores entries and their recency order
+TEST(CacheSnapshotTest, RoundTripPreservesOrder) {
+    SnapshotFile file("order");
+    IntLRUCache cache(5);
+    for (int k = 1; k <= 5; ++k) cache.put(k, k * 10);
+    cache.get(2);
+    cache.get(4);
+    save_snapshot(cache, file.path);
+
+    IntLRUCache restored(5);
+    EXPECT_EQ(load_snapshot(restored, file.path), 5u);
+    EXPECT_EQ(contents(restored), contents(cache));
+    restored.put(6, 60);   // evicts the coldest, as the original would
+    EXPECT_EQ(restored.get(1), -1);
+    EXPECT_EQ(restored.get(3), 30);
+}
+
+// The header and entries are laid out compactly
+TEST(CacheSnapshotTest, FileIsCompact) {
+    SnapshotFile file("compact");
+    LRUCache<uint32_t, uint64_t> cache(100);
+    for (uint32_t k = 0; k < 100; ++k) cache.put(k, k);
+    save_snapshot(cache, file.path);
+    EXPECT_EQ(file.bytes().size(), sizeof(SnapshotHeader) + 100 * (4 + 8));
+}
+
+// Variable-length strings survive the round trip
+TEST(CacheSnapshotTest, StringKeysAndValues) {
+    SnapshotFile file("strings");
+    StringLRUCache<std::string> cache(8);
+    cache.put(std::string("alpha"), std::string("first"));
+    cache.put(std::string(""), std::string("empty key"));
+    cache.put(std::string("long"), std::string(10000, 'x'));
+    save_snapshot(cache, file.path);
+
+    StringLRUCache<std::string> restored(8);
+    EXPECT_EQ(load_snapshot(restored, file.path), 3u);
+    EXPECT_EQ(contents(restored), contents(cache));
+    EXPECT_EQ(restored.peek("long")->size(), 10000u);
+}
+
+// Loading into a smaller cache keeps the hottest entries
+TEST(CacheSnapshotTest, SmallerCacheKeepsHottest) {
+    SnapshotFile file("smaller");
+    IntLRUCache cache(10);
+    for (int k = 0; k < 10; ++k) cache.put(k, k);
+    save_snapshot(cache, file.path);
+    IntLRUCache small(3);
+    EXPECT_EQ(load_snapshot(small, file.path), 10u);
+    EXPECT_EQ(contents(small), (Entries{{7, 7}, {8, 8}, {9, 9}}));
+}
+
+// An empty cache saves and loads
+TEST(CacheSnapshotTest, EmptyCache) {
+    SnapshotFile file("empty");
+    IntLRUCache cache(4);
+    save_snapshot(cache, file.path);
+    IntLRUCache restored(4);
+    EXPECT_EQ(load_snapshot(restored, file.path), 0u);
+    EXPECT_EQ(restored.size(), 0u);
+}
+
+// Saving replaces an existing snapshot and leaves no temporary file behind
+TEST(CacheSnapshotTest, SaveReplacesExistingFile) {
+    SnapshotFile file("replace");
+    IntLRUCache cache(4);
+    cache.put(1, 1);
+    save_snapshot(cache, file.path);
+    cache.put(2, 2);
+    save_snapshot(cache, file.path);
+    IntLRUCache restored(4);
+    EXPECT_EQ(load_snapshot(restored, file.path), 2u);
+    EXPECT_NE(::access((file.path + ".tmp").c_str(), F_OK), 0);
+}
+
+// A flipped payload byte fails the checksum and leaves the cache untouched
+TEST(CacheSnapshotTest, CorruptionDetected) {
+    SnapshotFile file("corrupt");
+    IntLRUCache cache(64);
+    for (int k = 0; k < 64; ++k) cache.put(k, k);
+    save_snapshot(cache, file.path);
+    std::string data = file.bytes();
+    data[sizeof(SnapshotHeader) + 77] ^= 0x10;
+    file.overwrite(data);
+
+    IntLRUCache restored(64);
+    restored.put(-1, -1);
+    EXPECT_THROW(load_snapshot(restored, file.path), SnapshotError);
+    EXPECT_EQ(contents(restored), (Entries{{-1, -1}}));
+}
+
+// Truncated files, bad magic and unknown versions are rejected
+TEST(CacheSnapshotTest, MalformedFilesRejected) {
+    SnapshotFile file("malformed");
+    IntLRUCache cache(8);
+    for (int k = 0; k < 8; ++k) cache.put(k, k);
+    save_snapshot(cache, file.path);
+    const std::string good = file.bytes();
+    IntLRUCache restored(8);
+
+    file.overwrite(good.substr(0, good.size() - 3));
+    EXPECT_THROW(load_snapshot(restored, file.path), SnapshotError);
+    file.overwrite(good.substr(0, 20));
+    EXPECT_THROW(load_snapshot(restored, file.path), SnapshotError);
+
+    std::string bad_magic = good;
+    bad_magic[0] = 'X';
+    file.overwrite(bad_magic);
+    EXPECT_THROW(load_snapshot(restored, file.path), SnapshotError);
+
+    std::string future = good;
+    future[8] = 3;   // version, low byte
+    file.overwrite(future);
+    EXPECT_THROW(load_snapshot(restored, file.path), SnapshotError);
+    EXPECT_EQ(restored.size(), 0u);
+}
+
+// Entries that do not match the payload fail before anything is loaded,
+// even when the checksum holds
+TEST(CacheSnapshotTest, MalformedPayloadLeavesCacheUntouched) {
+    SnapshotFile file("layout");
+    StringLRUCache<std::string> cache(8);
+    for (int k = 0; k < 6; ++k) cache.put(std::to_string(k), std::string(k, 'v'));
+    save_snapshot(cache, file.path);
+    const std::string good = file.bytes();
+
+    StringLRUCache<std::string> restored(8);
+    restored.put(std::string("kept"), std::string("yes"));
+    for (uint64_t entries : {uint64_t(5), uint64_t(7), uint64_t(1) << 40}) {
+        std::string forged = good;
+        std::memcpy(&forged[offsetof(SnapshotHeader, entries)], &entries, sizeof(entries));
+        file.overwrite(forged);
+        EXPECT_THROW(load_snapshot(restored, file.path), SnapshotError) << entries << " entries";
+        EXPECT_EQ(restored.size(), 1u);
+    }
+
+    // The last entry is "5" -> "vvvvv": make its value's length run past the
+    // end of the file, and redo the checksum to match.
+    std::string forged = good;
+    const uint32_t too_long = 1000;
+    std::memcpy(&forged[forged.size() - 5 - sizeof(too_long)], &too_long, sizeof(too_long));
+    SnapshotChecksum sum;
+    sum.update(reinterpret_cast<const unsigned char*>(forged.data()) + sizeof(SnapshotHeader),
+               forged.size() - sizeof(SnapshotHeader));
+    const uint64_t digest = sum.digest();
+    std::memcpy(&forged[offsetof(SnapshotHeader, checksum)], &digest, sizeof(digest));
+    file.overwrite(forged);
+    EXPECT_THROW(load_snapshot(restored, file.path), SnapshotError);
+    EXPECT_EQ(contents(restored), (std::vector<std::pair<std::string, std::string>>{{"kept", "yes"}}));
+}
+
+// A snapshot of other key or value types is rejected
+TEST(CacheSnapshotTest, TypeMismatchRejected) {
+    SnapshotFile file("types");
+    IntLRUCache cache(4);
+    cache.put(1, 1);
+    save_snapshot(cache, file.path);
+    LRUCache<int, int64_t> wide(4);
+    EXPECT_THROW(load_snapshot(wide, file.path), SnapshotError);
+    StringLRUCache<int> strings(4);
+    EXPECT_THROW(load_snapshot(strings, file.path), SnapshotError);
+    LRUCache<int, float> floats(4);
+    EXPECT_THROW(load_snapshot(floats, file.path), SnapshotError);
+    LRUCache<unsigned, int> unsigned_keys(4);
+    EXPECT_THROW(load_snapshot(unsigned_keys, file.path), SnapshotError);
+    EXPECT_EQ(floats.size() + unsigned_keys.size(), 0u);
+}
+
+// A weighted cache too small for one of the entries rejects the snapshot
+// before loading any of them
+TEST(CacheSnapshotTest, OverweightEntryLeavesCacheUntouched) {
+    SnapshotFile file("weight");
+    WeightedLRUCache<int, std::string, ValueLength> cache(100);
+    cache.put(1, std::string(5, 'a'));
+    cache.put(2, std::string(30, 'b'));
+    cache.put(3, std::string(5, 'c'));
+    save_snapshot(cache, file.path);
+
+    WeightedLRUCache<int, std::string, ValueLength> small(20);
+    small.put(9, std::string("kept"));
+    EXPECT_THROW(load_snapshot(small, file.path), SnapshotError);
+    EXPECT_EQ(contents(small), (std::vector<std::pair<int, std::string>>{{9, "kept"}}));
+
+    WeightedLRUCache<int, std::string, ValueLength> roomy(40);
+    EXPECT_EQ(load_snapshot(roomy, file.path), 3u);
+    EXPECT_EQ(roomy.weight(), 40u);
+}
+
+// Missing files and unwritable paths throw
+TEST(CacheSnapshotTest, IoErrors) {
+    IntLRUCache cache(4);
+    EXPECT_THROW(load_snapshot(cache, ::testing::TempDir() + "no_such_snapshot"), SnapshotError);
+    EXPECT_THROW(save_snapshot(cache, "/nonexistent-dir/snapshot"), SnapshotError);
+}
+
+// The checksum is independent of how the payload is fed to it
+TEST(CacheSnapshotTest, ChecksumIsIncremental) {
+    std::vector<unsigned char> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<unsigned char>(i * 7 + 3);
+    SnapshotChecksum whole;
+    whole.update(data.data(), data.size());
+    SnapshotChecksum pieces;
+    for (size_t i = 0, step = 1; i < data.size(); i += step, step = step % 37 + 1)
+        pieces.update(data.data() + i, std::min(step, data.size() - i));
+    EXPECT_EQ(whole.digest(), pieces.digest());
+    data[500] ^= 1;
+    SnapshotChecksum flipped;
+    flipped.update(data.data(), data.size());
+    EXPECT_NE(whole.digest(), flipped.digest());
+}
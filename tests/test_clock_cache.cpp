@@ -0,0 +1,155 @@
+#include "ClockCache.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+// Straightforward single-threaded CLOCK, to say which keys ClockCache holds.
+class ClockModel {
+public:
+    explicit ClockModel(size_t cap) : cap(cap) {}
+
+    bool get(int key) {
+        auto it = where.find(key);
+        if (it == where.end()) return false;
+        slots[it->second].referenced = true;
+        return true;
+    }
+
+    void put(int key) {
+        auto it = where.find(key);
+        if (it != where.end()) {
+            slots[it->second].referenced = true;
+            return;
+        }
+        size_t slot = slots.size();
+        if (slot < cap) {
+            slots.push_back({key, false});
+        } else {
+            while (slots[hand].referenced) {
+                slots[hand].referenced = false;
+                hand = (hand + 1) % cap;
+            }
+            slot = hand;
+            hand = (hand + 1) % cap;
+            where.erase(slots[slot].key);
+            slots[slot] = {key, false};
+        }
+        where[key] = slot;
+    }
+
+private:
+    struct Slot {
+        int key;
+        bool referenced;
+    };
+    size_t cap;
+    size_t hand = 0;
+    std::vector<Slot> slots;
+    std::unordered_map<int, size_t> where;
+};
+}
+
+// Basic put/get, misses and value updates
+TEST(ClockCacheTest, PutGetUpdate) {
+    ClockCache cache(4);
+    EXPECT_EQ(cache.get(1), -1);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    EXPECT_EQ(cache.get(1), 10);
+    cache.put(1, 11);
+    EXPECT_EQ(cache.get(1), 11);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.capacity(), 4u);
+}
+
+// Negative keys and values survive the packed representation
+TEST(ClockCacheTest, NegativeKeysAndValues) {
+    ClockCache cache(4);
+    cache.put(-5, -7);
+    cache.put(0, 0);
+    EXPECT_EQ(cache.get(-5), -7);
+    EXPECT_EQ(cache.get(0), 0);
+}
+
+// Zero capacity is rejected
+TEST(ClockCacheTest, ZeroCapacityThrows) {
+    EXPECT_THROW(ClockCache(0), std::invalid_argument);
+}
+
+// A referenced entry gets a second chance; the unreferenced one is evicted
+TEST(ClockCacheTest, SecondChance) {
+    ClockCache cache(3);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+    EXPECT_EQ(cache.get(1), 1);
+    cache.put(4, 4);   // hand skips 1 (clearing it), evicts 2
+    EXPECT_EQ(cache.get(2), -1);
+    EXPECT_EQ(cache.get(1), 1);
+    EXPECT_EQ(cache.get(3), 3);
+    EXPECT_EQ(cache.get(4), 4);
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+// Random churn hits and misses exactly as a reference CLOCK does, and every
+// hit returns the latest value put
+TEST(ClockCacheTest, RandomChurnMatchesReference) {
+    ClockCache cache(64);
+    ClockModel model(64);
+    std::unordered_map<int, int> latest;
+    std::mt19937 rng(3);
+    int hits = 0;
+    for (int i = 0; i < 100000; ++i) {
+        int key = static_cast<int>(rng() % 500);
+        if (rng() % 2) {
+            cache.put(key, i);
+            model.put(key);
+            latest[key] = i;
+        } else {
+            int v = cache.get(key);
+            if (model.get(key)) {
+                ASSERT_NE(v, -1) << "key " << key << " at step " << i;
+                ASSERT_EQ(v, latest[key]);
+                ++hits;
+            } else {
+                ASSERT_EQ(v, -1) << "key " << key << " at step " << i;
+            }
+        }
+    }
+    EXPECT_GT(hits, 0);
+    EXPECT_EQ(cache.size(), 64u);
+    int present = 0;
+    for (int key = 0; key < 500; ++key) present += cache.get(key) != -1;
+    EXPECT_EQ(present, 64);
+}
+
+// Lock-free readers racing a writer only ever see values that were put
+TEST(ClockCacheTest, ConcurrentReadersSeeConsistentPairs) {
+    ClockCache cache(128);
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> readers;
+    std::atomic<int> bad{0};
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            std::mt19937 rng(static_cast<unsigned>(t));
+            while (!stop.load()) {
+                int key = static_cast<int>(rng() % 1000);
+                int v = cache.get(key);
+                if (v != -1 && v % 1000 != key) ++bad;
+            }
+        });
+    }
+    std::mt19937 rng(9);
+    for (int i = 0; i < 200000; ++i) {
+        int key = static_cast<int>(rng() % 1000);
+        cache.put(key, key + 1000 * (i % 1000));
+    }
+    stop = true;
+    for (auto& r : readers) r.join();
+    EXPECT_EQ(bad.load(), 0);
+}
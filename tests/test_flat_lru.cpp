@@ -0,0 +1,116 @@
+#include "FlatLRUCache.h"
+#include "LRUCache.h"
+#include "allocation_counter.h"
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+
+// Same put/get/evict behaviour as the original cache
+TEST(FlatLRUCacheTest, BasicLRUSemantics) {
+    FlatLRUCache cache(2);
+    EXPECT_EQ(cache.get(1), -1);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.get(1);
+    cache.put(3, 30);
+    EXPECT_EQ(cache.get(2), -1);
+    EXPECT_EQ(cache.get(1), 10);
+    EXPECT_EQ(cache.get(3), 30);
+    cache.put(3, 31);
+    EXPECT_EQ(cache.get(3), 31);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+// Zero capacity is rejected
+TEST(FlatLRUCacheTest, ZeroCapacityThrows) {
+    EXPECT_THROW(FlatLRUCache(0), std::invalid_argument);
+}
+
+// A random workload evicts exactly what the node-based LRUCache evicts
+TEST(FlatLRUCacheTest, MatchesLRUCacheOnRandomWorkload) {
+    for (size_t capacity : {1, 7, 64, 1000}) {
+        FlatLRUCache<int, int> flat(capacity);
+        IntLRUCache reference(capacity);
+        std::mt19937 rng(static_cast<unsigned>(capacity));
+        for (int i = 0; i < 50000; ++i) {
+            int key = static_cast<int>(rng() % (capacity * 3));
+            if (rng() % 3 == 0) {
+                flat.put(key, i);
+                reference.put(key, i);
+            } else {
+                ASSERT_EQ(flat.get(key), reference.get(key)) << "capacity " << capacity << " op " << i;
+            }
+        }
+        EXPECT_EQ(flat.size(), reference.size());
+    }
+}
+
+// After construction, puts that evict never allocate
+TEST(FlatLRUCacheTest, SteadyStatePutDoesNotAllocate) {
+    FlatLRUCache<int, int> cache(1024);
+    size_t count;
+    {
+        AllocationScope scope;
+        for (int k = 0; k < 100000; ++k) cache.put(k, k);
+        count = scope.count();
+    }
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(cache.get(99999), 99999);
+    EXPECT_EQ(cache.get(0), -1);
+}
+
+// String keys support string_view lookups
+TEST(FlatLRUCacheTest, HeterogeneousStringKeys) {
+    FlatLRUCache<std::string, int, TransparentStringHash, std::equal_to<>> cache(4);
+    cache.put(std::string(40, 'a'), 1);
+    cache.put(std::string_view("bee"), 2);
+    EXPECT_EQ(cache.get(std::string_view("bee")), 2);
+    EXPECT_EQ(cache.get(std::string(40, 'a')), 1);
+    EXPECT_EQ(cache.get("nope"), -1);
+}
+
+// Evicted and remaining values are destroyed exactly once
+TEST(FlatLRUCacheTest, DestroysValues) {
+    auto token = std::make_shared<int>(0);
+    {
+        FlatLRUCache<int, std::shared_ptr<int>> cache(3);
+        for (int k = 0; k < 10; ++k) cache.put(k, token);
+        EXPECT_EQ(token.use_count(), 4);
+        cache.emplace(9, token);   // overwrite keeps the count
+        EXPECT_EQ(token.use_count(), 4);
+    }
+    EXPECT_EQ(token.use_count(), 1);
+}
+
+// try_get, peek and get_or_compute mirror LRUCache
+TEST(FlatLRUCacheTest, LookupApi) {
+    FlatLRUCache<int, int> cache(2);
+    cache.put(1, -1);
+    ASSERT_NE(cache.try_get(1), nullptr);
+    EXPECT_EQ(*cache.try_get(1), -1);
+    EXPECT_EQ(cache.try_get(5), nullptr);
+    int loads = 0;
+    EXPECT_EQ(cache.get_or_compute(2, [&] { ++loads; return 20; }), 20);
+    EXPECT_EQ(cache.get_or_compute(2, [&] { ++loads; return 21; }), 20);
+    EXPECT_EQ(loads, 1);
+    EXPECT_EQ(*cache.peek(1), -1);   // 1 stays least recently used
+    cache.get_or_compute(3, [] { return 30; });
+    EXPECT_EQ(cache.peek(1), nullptr);
+    EXPECT_EQ(*cache.peek(2), 20);
+}
+
+// get_or_compute keeps the index consistent through evictions
+TEST(FlatLRUCacheTest, GetOrComputeMatchesLRUCache) {
+    FlatLRUCache<int, int> flat(50);
+    IntLRUCache reference(50);
+    std::mt19937 rng(11);
+    for (int i = 0; i < 50000; ++i) {
+        int key = static_cast<int>(rng() % 200);
+        int a = flat.get_or_compute(key, [&] { return i; });
+        int b = reference.get_or_compute(key, [&] { return i; });
+        ASSERT_EQ(a, b) << "op " << i;
+    }
+}
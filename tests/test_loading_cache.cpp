@@ -0,0 +1,192 @@
+#include "LoadingCache.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+// Stand-in backend: counts calls and, while `hold` is set, makes every call
+// wait until release() so tests can pile up misses behind one load.
+struct StubBackend {
+    std::atomic<int> calls{0};
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    bool hold = false;
+
+    int load(int key) {
+        int n = ++calls;
+        if (hold) opened.wait();
+        return key * 100 + n;
+    }
+
+    void release() { gate.set_value(); }
+
+    LoadingCache<int, int>::Loader loader() {
+        return [this](const int& key) { return load(key); };
+    }
+};
+
+struct ManualClock {
+    static inline int64_t reading = 0;
+    int64_t now() const { return reading; }
+};
+}
+
+// A miss loads through the pool once; later gets hit
+TEST(LoadingCacheTest, LoadsOnMissThenHits) {
+    SimpleThreadPool pool(2);
+    StubBackend backend;
+    LoadingCache<int, int> cache(pool, 8, backend.loader());
+    EXPECT_EQ(cache.get_if_present(1), std::nullopt);
+    EXPECT_EQ(cache.get(1), 101);
+    EXPECT_EQ(cache.get(1), 101);
+    EXPECT_EQ(cache.get_async(1).get(), 101);
+    EXPECT_EQ(cache.get_if_present(1), 101);
+    EXPECT_EQ(backend.calls.load(), 1);
+}
+
+// Every miss on a key while its load is in flight shares that load
+TEST(LoadingCacheTest, CoalescesConcurrentMisses) {
+    SimpleThreadPool pool(2);
+    StubBackend backend;
+    backend.hold = true;
+    LoadingCache<int, int> cache(pool, 8, backend.loader());
+    std::vector<PoolFuture<int>> waiters;
+    for (int i = 0; i < 100; ++i) waiters.push_back(cache.get_async(7));
+    EXPECT_EQ(cache.loads_in_flight(), 1u);
+    backend.release();
+    for (auto& w : waiters) EXPECT_EQ(w.get(), 701);
+    EXPECT_EQ(backend.calls.load(), 1);
+    EXPECT_EQ(cache.loads_in_flight(), 0u);
+}
+
+// Threads missing on a hot key at once trigger a single backend call
+TEST(LoadingCacheTest, MissStormFromManyThreads) {
+    SimpleThreadPool pool(2);
+    StubBackend backend;
+    backend.hold = true;
+    LoadingCache<int, int> cache(pool, 8, backend.loader());
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 16; ++t)
+        threads.emplace_back([&] {
+            if (cache.get(3) != 301) ++wrong;
+        });
+    std::this_thread::sleep_for(20ms);
+    backend.release();
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(wrong.load(), 0);
+    EXPECT_EQ(backend.calls.load(), 1);
+}
+
+// Different keys load independently
+TEST(LoadingCacheTest, DistinctKeysLoadSeparately) {
+    SimpleThreadPool pool(2);
+    StubBackend backend;
+    backend.hold = true;
+    LoadingCache<int, int> cache(pool, 8, backend.loader());
+    auto a = cache.get_async(1);
+    auto b = cache.get_async(2);
+    EXPECT_EQ(cache.loads_in_flight(), 2u);
+    backend.release();
+    EXPECT_EQ(a.get() / 100, 1);
+    EXPECT_EQ(b.get() / 100, 2);
+    EXPECT_EQ(backend.calls.load(), 2);
+}
+
+// A failed load reaches every waiter, is not cached, and the next miss retries
+TEST(LoadingCacheTest, LoaderExceptionPropagatesAndIsNotCached) {
+    SimpleThreadPool pool(2);
+    std::atomic<int> calls{0};
+    LoadingCache<int, int> cache(pool, 8, [&](const int& key) {
+        if (++calls == 1) throw std::runtime_error("backend down");
+        return key;
+    });
+    auto first = cache.get_async(5);
+    EXPECT_THROW(first.get(), std::runtime_error);
+    EXPECT_EQ(cache.get_if_present(5), std::nullopt);
+    EXPECT_EQ(cache.get(5), 5);
+    EXPECT_EQ(calls.load(), 2);
+}
+
+// invalidate detaches the load in flight: its waiters still get its value,
+// but the next miss loads afresh and only that result is cached
+TEST(LoadingCacheTest, InvalidateDetachesInFlightLoad) {
+    SimpleThreadPool pool(3);
+    StubBackend backend;
+    backend.hold = true;
+    LoadingCache<int, int> cache(pool, 8, backend.loader());
+    auto stale = cache.get_async(4);
+    while (backend.calls.load() < 1) std::this_thread::yield();
+    cache.invalidate(4);
+    auto fresh = cache.get_async(4);
+    backend.release();
+    EXPECT_EQ(stale.get(), 401);
+    EXPECT_EQ(fresh.get(), 402);
+    EXPECT_EQ(cache.get_if_present(4), 402);
+}
+
+// An explicit put wins over a load that was already running
+TEST(LoadingCacheTest, PutOverridesInFlightLoad) {
+    SimpleThreadPool pool(2);
+    StubBackend backend;
+    backend.hold = true;
+    LoadingCache<int, int> cache(pool, 8, backend.loader());
+    auto pending = cache.get_async(9);
+    cache.put(9, 42);
+    backend.release();
+    EXPECT_EQ(pending.get(), 901);
+    pool.wait_idle();
+    EXPECT_EQ(cache.get_if_present(9), 42);
+    EXPECT_EQ(cache.get(9), 42);
+}
+
+// Continuations chain off loads without blocking a worker
+TEST(LoadingCacheTest, AsyncContinuation) {
+    SimpleThreadPool pool(1);
+    StubBackend backend;
+    LoadingCache<int, int> cache(pool, 8, backend.loader());
+    auto doubled = cache.get_async(2).then([](const int& v) { return v * 2; });
+    EXPECT_EQ(doubled.get(), 402);
+}
+
+// Destroying the cache waits for loads still running
+TEST(LoadingCacheTest, DestructorWaitsForLoads) {
+    SimpleThreadPool pool(2);
+    std::atomic<bool> finished{false};
+    {
+        LoadingCache<int, int> cache(pool, 8, [&](const int& key) {
+            std::this_thread::sleep_for(30ms);
+            finished = true;
+            return key;
+        });
+        cache.get_async(1);
+    }
+    EXPECT_TRUE(finished.load());
+}
+
+// Over an expiring cache, an expired key is loaded again
+TEST(LoadingCacheTest, ReloadsAfterExpiry) {
+    SimpleThreadPool pool(2);
+    StubBackend backend;
+    ExpiringLRUCache<int, int, ManualClock> lru(8);
+    lru.set_default_ttl(1s);
+    LoadingCache<int, int, ExpiringLRUCache<int, int, ManualClock>> cache(pool, std::move(lru),
+                                                                          backend.loader());
+    EXPECT_EQ(cache.get(1), 101);
+    EXPECT_EQ(cache.get(1), 101);
+    ManualClock::reading += std::chrono::nanoseconds(2s).count();
+    EXPECT_EQ(cache.get(1), 102);
+}
+
+// A loader is required
+TEST(LoadingCacheTest, MissingLoaderThrows) {
+    SimpleThreadPool pool(1);
+    EXPECT_THROW((LoadingCache<int, int>(pool, 8, nullptr)), std::invalid_argument);
+}
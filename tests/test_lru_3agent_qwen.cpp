@@ -9,7 +9,7 @@ protected:
     // FIX: Initialize 'cache' with a capacity of 2 in the initializer list
     LRUCacheTest() : cache(2) {} 
 
-    LRUCache cache; 
+    IntLRUCache cache; 
 };
 
 // Test case: Construct with valid capacity
@@ -0,0 +1,83 @@
+#include "FlatLRUCache.h"
+#include "LRUCache.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+// Drives `batched` with get_many/put_many and `single` with get/put over the
+// same random batches (duplicates and evictions included), checking every
+// result and, at the end, that both hold the same keys in the same order.
+template<class Cache>
+void expect_batches_match_singles(size_t capacity, size_t batch) {
+    Cache batched(capacity), single(capacity);
+    std::mt19937 rng(static_cast<unsigned>(capacity * 31 + batch));
+    std::vector<int> keys(batch), values(batch), out(batch);
+    for (int round = 0; round < 400; ++round) {
+        for (size_t i = 0; i < batch; ++i) {
+            keys[i] = static_cast<int>(rng() % (capacity * 3));
+            values[i] = static_cast<int>(rng() % 1000);
+        }
+        if (round % 2) {
+            batched.put_many(keys.data(), values.data(), batch);
+            for (size_t i = 0; i < batch; ++i) single.put(keys[i], values[i]);
+        } else {
+            size_t hits = batched.get_many(keys.data(), batch, out.data());
+            size_t expected_hits = 0;
+            for (size_t i = 0; i < batch; ++i) {
+                int v = single.get(keys[i]);
+                expected_hits += v != -1;
+                ASSERT_EQ(out[i], v);
+            }
+            ASSERT_EQ(hits, expected_hits);
+        }
+    }
+    ASSERT_EQ(batched.size(), single.size());
+    // Refilling evicts in recency order, so equal survivors mean equal order.
+    for (size_t n = 1; n <= capacity; n += capacity / 4 + 1) {
+        for (size_t i = 0; i < n; ++i) {
+            batched.put(-1 - static_cast<int>(i), 0);
+            single.put(-1 - static_cast<int>(i), 0);
+        }
+        for (int k = 0; k < static_cast<int>(capacity * 3); ++k)
+            ASSERT_EQ(batched.peek(k) != nullptr, single.peek(k) != nullptr) << "key " << k;
+    }
+}
+}
+
+// get_many and put_many behave exactly like the equivalent single calls
+TEST(LRUCacheBatchTest, MatchesSingleCalls) {
+    for (size_t capacity : {1, 10, 100, 1000})
+        for (size_t batch : {1, 5, 16, 17, 200}) expect_batches_match_singles<IntLRUCache>(capacity, batch);
+}
+
+// Same for FlatLRUCache
+TEST(LRUCacheBatchTest, FlatMatchesSingleCalls) {
+    for (size_t capacity : {1, 10, 100, 1000})
+        for (size_t batch : {1, 5, 16, 17, 200}) expect_batches_match_singles<FlatLRUCache<int, int>>(capacity, batch);
+}
+
+// Empty batches are fine
+TEST(LRUCacheBatchTest, EmptyBatch) {
+    IntLRUCache cache(4);
+    EXPECT_EQ(cache.get_many(static_cast<const int*>(nullptr), 0, nullptr), 0u);
+    cache.put_many(static_cast<const int*>(nullptr), nullptr, 0);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+// Transparent caches take batches of lookup keys, e.g. string_views
+TEST(LRUCacheBatchTest, HeterogeneousKeys) {
+    StringLRUCache<int> cache(8);
+    const std::string_view keys[] = {"alpha", "beta", "gamma"};
+    const int values[] = {1, 2, 3};
+    cache.put_many(keys, values, 3);
+    const std::string_view lookups[] = {"gamma", "delta", "alpha"};
+    int out[3];
+    EXPECT_EQ(cache.get_many(lookups, 3, out), 2u);
+    EXPECT_EQ(out[0], 3);
+    EXPECT_EQ(out[1], -1);
+    EXPECT_EQ(out[2], 1);
+}
@@ -0,0 +1,257 @@
+#include "LRUCache.h"
+#include "allocation_counter.h"
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+// Value type that records how it was constructed.
+struct Tracked {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    static void reset() { copies = moves = 0; }
+
+    Tracked() = default;
+    Tracked(int a, int b) : value(a * b) {}
+    Tracked(const Tracked& o) : value(o.value) { ++copies; }
+    Tracked(Tracked&& o) noexcept : value(o.value) { ++moves; }
+    Tracked& operator=(const Tracked& o) { value = o.value; ++copies; return *this; }
+    Tracked& operator=(Tracked&& o) noexcept { value = o.value; ++moves; return *this; }
+
+    int value = 0;
+};
+
+// Allocator that counts the allocations made through it.
+template<class T>
+struct CountingAllocator {
+    using value_type = T;
+    explicit CountingAllocator(size_t* c) : counter(c) {}
+    template<class U>
+    CountingAllocator(const CountingAllocator<U>& o) : counter(o.counter) {}
+
+    T* allocate(size_t n) {
+        ++*counter;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    template<class U>
+    bool operator==(const CountingAllocator<U>& o) const { return counter == o.counter; }
+    template<class U>
+    bool operator!=(const CountingAllocator<U>& o) const { return counter != o.counter; }
+
+    size_t* counter;
+};
+
+// Every key lands in the same bucket.
+struct ConstantHash {
+    size_t operator()(int) const { return 42; }
+};
+
+// LruPolicy that counts the misses it is told about.
+struct MissCountingPolicy : LruPolicy {
+    using LruPolicy::LruPolicy;
+    static inline int misses = 0;
+    void on_miss(size_t h) {
+        ++misses;
+        LruPolicy::on_miss(h);
+    }
+};
+
+// Counts how often the cache hashes a key.
+struct CountingHash {
+    static inline int calls = 0;
+    size_t operator()(int k) const {
+        ++calls;
+        return std::hash<int>()(k);
+    }
+};
+}
+
+// The defaults and the alias still name the original int -> int cache
+TEST(LRUCacheGenericTest, IntDefaultsKeepOriginalApi) {
+    LRUCache cache(2);
+    static_assert(std::is_same<decltype(cache), IntLRUCache>::value, "int,int by default");
+    EXPECT_EQ(cache.get(1), -1);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.get(1);
+    cache.put(3, 30);
+    EXPECT_EQ(cache.get(2), -1);
+    EXPECT_EQ(cache.get(1), 10);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.capacity(), 2u);
+}
+
+// String keys and values; a miss yields an empty value
+TEST(LRUCacheGenericTest, StringKeysAndValues) {
+    LRUCache<std::string, std::string> cache(2);
+    cache.put("alpha", "one");
+    cache.put(std::string("beta"), std::string("two"));
+    EXPECT_EQ(cache.get("alpha"), "one");
+    cache.put("gamma", "three");
+    EXPECT_EQ(cache.get("beta"), "");
+    EXPECT_EQ(cache.get("gamma"), "three");
+}
+
+// Lookups and overwrites by string_view build no temporary key
+TEST(LRUCacheGenericTest, HeterogeneousLookupDoesNotAllocate) {
+    StringLRUCache<int> cache(4);
+    const std::string key(64, 'k');
+    cache.put(key, 1);
+    std::string_view view(key);
+    size_t count;
+    int value;
+    {
+        AllocationScope scope;
+        value = cache.get(view);
+        cache.put(view, 2);
+        count = scope.count();
+    }
+    EXPECT_EQ(value, 1);
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(cache.get("missing"), -1);
+    EXPECT_EQ(cache.get(key), 2);
+}
+
+// put moves rvalues in; emplace constructs the value in place
+TEST(LRUCacheGenericTest, MoveAwarePutAndEmplace) {
+    LRUCache<int, Tracked> cache(4);
+    Tracked::reset();
+    cache.put(1, Tracked(2, 3));
+    EXPECT_EQ(Tracked::copies, 0);
+    EXPECT_EQ(Tracked::moves, 1);
+
+    Tracked::reset();
+    Tracked& t = cache.emplace(2, 4, 5);
+    EXPECT_EQ(t.value, 20);
+    EXPECT_EQ(Tracked::copies, 0);
+    EXPECT_EQ(Tracked::moves, 0);
+
+    Tracked::reset();
+    cache.emplace(2, 1, 1);   // existing key: assigned, not copied
+    EXPECT_EQ(cache.get(2).value, 1);
+    EXPECT_EQ(Tracked::moves, 1);
+}
+
+// Move-only values can be stored
+TEST(LRUCacheGenericTest, MoveOnlyValues) {
+    LRUCache<int, std::unique_ptr<int>> cache(1);
+    cache.put(1, std::make_unique<int>(7));
+    EXPECT_EQ(*cache.emplace(2, new int(8)), 8);   // evicts 1
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+// Once full, eviction reuses node storage instead of allocating
+TEST(LRUCacheGenericTest, CustomAllocatorAndNodeReuse) {
+    size_t count = 0;
+    using Alloc = CountingAllocator<std::pair<const int, int>>;
+    LRUCache<int, int, std::hash<int>, std::equal_to<int>, Alloc> cache(16, {}, {}, Alloc(&count));
+    for (int k = 0; k < 16; ++k) cache.put(k, k);
+    size_t warm = count;
+    for (int k = 16; k < 1000; ++k) cache.put(k, k);
+    EXPECT_EQ(count, warm);
+    EXPECT_EQ(cache.get(999), 999);
+    EXPECT_EQ(cache.get(983), -1);
+}
+
+// Collisions in every bucket keep working through eviction
+TEST(LRUCacheGenericTest, CollidingHash) {
+    LRUCache<int, int, ConstantHash> cache(8);
+    for (int k = 0; k < 20; ++k) cache.put(k, k * 10);
+    for (int k = 0; k < 12; ++k) EXPECT_EQ(cache.get(k), -1);
+    for (int k = 12; k < 20; ++k) EXPECT_EQ(cache.get(k), k * 10);
+}
+
+// Copies keep contents and recency order; moves transfer them
+TEST(LRUCacheGenericTest, CopyAndMove) {
+    IntLRUCache a(3);
+    a.put(1, 1);
+    a.put(2, 2);
+    a.put(3, 3);
+    a.get(1);            // order, most recent first: 1 3 2
+    IntLRUCache b(a);
+    b.put(4, 4);         // evicts 2
+    EXPECT_EQ(b.get(2), -1);
+    EXPECT_EQ(b.get(1), 1);
+    EXPECT_EQ(a.get(2), 2);
+    IntLRUCache c(std::move(b));
+    EXPECT_EQ(c.size(), 3u);
+    EXPECT_EQ(c.get(4), 4);
+}
+
+// try_get tells a cached -1 apart from a miss
+TEST(LRUCacheGenericTest, TryGetDistinguishesMiss) {
+    IntLRUCache cache(2);
+    cache.put(1, -1);
+    ASSERT_NE(cache.try_get(1), nullptr);
+    EXPECT_EQ(*cache.try_get(1), -1);
+    EXPECT_EQ(cache.try_get(2), nullptr);
+    *cache.try_get(1) = 5;
+    EXPECT_EQ(cache.get(1), 5);
+}
+
+// peek reads without refreshing recency
+TEST(LRUCacheGenericTest, PeekDoesNotTouchRecency) {
+    IntLRUCache cache(2);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    ASSERT_NE(cache.peek(1), nullptr);
+    EXPECT_EQ(*cache.peek(1), 10);
+    EXPECT_EQ(cache.peek(3), nullptr);
+    cache.put(3, 30);   // 1 is still least recently used
+    EXPECT_EQ(cache.peek(1), nullptr);
+    EXPECT_NE(cache.peek(2), nullptr);
+}
+
+// get_or_compute loads once on a miss and hashes once per call
+TEST(LRUCacheGenericTest, GetOrComputeSingleProbe) {
+    LRUCache<int, int, CountingHash> cache(2);
+    int loads = 0;
+    auto loader = [&] { ++loads; return 42; };
+    CountingHash::calls = 0;
+    EXPECT_EQ(cache.get_or_compute(7, loader), 42);
+    EXPECT_EQ(CountingHash::calls, 1);
+    EXPECT_EQ(cache.get_or_compute(7, loader), 42);
+    EXPECT_EQ(loads, 1);
+    EXPECT_EQ(CountingHash::calls, 2);
+    cache.get_or_compute(8, loader);
+    cache.get_or_compute(9, loader);   // evicts 7
+    EXPECT_EQ(cache.peek(7), nullptr);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+// A throwing loader leaves the cache as it was
+TEST(LRUCacheGenericTest, GetOrComputeLoaderThrows) {
+    IntLRUCache cache(1);
+    cache.put(1, 1);
+    EXPECT_THROW(cache.get_or_compute(2, []() -> int { throw std::runtime_error("backend down"); }),
+                 std::runtime_error);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.get(1), 1);
+
+    // Nor does it count as a miss for the policy (TinyLFU's sketch)
+    LRUCache<int, int, std::hash<int>, std::equal_to<int>, std::allocator<std::pair<const int, int>>,
+             MissCountingPolicy> counted(1);
+    MissCountingPolicy::misses = 0;
+    EXPECT_THROW(counted.get_or_compute(2, []() -> int { throw std::runtime_error("backend down"); }),
+                 std::runtime_error);
+    EXPECT_EQ(MissCountingPolicy::misses, 0);
+    counted.get_or_compute(2, [] { return 2; });
+    EXPECT_EQ(MissCountingPolicy::misses, 1);
+}
+
+// reserve resizes the index up front without disturbing entries or order
+TEST(LRUCacheGenericTest, ReserveKeepsContents) {
+    IntLRUCache cache(1000);
+    for (int k = 0; k < 10; ++k) cache.put(k, k);
+    cache.reserve(1 << 20);   // clamped to the capacity
+    for (int k = 10; k < 1000; ++k) cache.put(k, k);
+    for (int k = 0; k < 1000; ++k) ASSERT_EQ(cache.get(k), k);
+    cache.put(1000, 1000);    // evicts 0, the least recently used
+    EXPECT_EQ(cache.peek(0), nullptr);
+}
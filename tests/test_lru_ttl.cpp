@@ -0,0 +1,237 @@
+#include "LRUCache.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+// Clock the tests move by hand; every cache using it shares the reading.
+struct ManualClock {
+    static inline int64_t reading = 0;
+    int64_t now() const { return reading; }
+};
+
+void advance(std::chrono::nanoseconds d) { ManualClock::reading += d.count(); }
+
+// Clock that moves on by a nanosecond every time it is read, so time passes
+// within a single cache call, as it can with CoarseClock.
+struct TickingClock {
+    static inline int64_t reading = 0;
+    int64_t now() const { return ++reading; }
+};
+
+using TtlCache = ExpiringLRUCache<int, int, ManualClock>;
+}
+
+// Without a TTL entries live until evicted, however much time passes
+TEST(ExpiringLRUCacheTest, DefaultIsForever) {
+    TtlCache cache(4);
+    cache.put(1, 10);
+    advance(1000h);
+    EXPECT_EQ(cache.get(1), 10);
+    EXPECT_EQ(cache.default_ttl(), TtlCache::forever);
+}
+
+// The default TTL applies to put, emplace and get_or_compute
+TEST(ExpiringLRUCacheTest, DefaultTtlExpires) {
+    TtlCache cache(8);
+    cache.set_default_ttl(10ms);
+    cache.put(1, 10);
+    cache.emplace(2, 20);
+    cache.get_or_compute(3, [] { return 30; });
+    advance(9ms);
+    EXPECT_EQ(cache.get(1), 10);
+    EXPECT_NE(cache.peek(2), nullptr);
+    advance(1ms);
+    EXPECT_EQ(cache.get(1), -1);
+    EXPECT_EQ(cache.try_get(2), nullptr);
+    EXPECT_EQ(cache.get_or_compute(3, [] { return 31; }), 31);
+}
+
+// A per-entry TTL overrides the default in either direction
+TEST(ExpiringLRUCacheTest, PerEntryTtl) {
+    TtlCache cache(8);
+    cache.set_default_ttl(10ms);
+    cache.put(1, 10, 1ms);
+    cache.put(2, 20, 1h);
+    cache.put(3, 30, TtlCache::forever);
+    advance(1s);
+    EXPECT_EQ(cache.get(1), -1);
+    EXPECT_EQ(cache.get(2), 20);
+    EXPECT_EQ(cache.get(3), 30);
+}
+
+// Overwriting restarts the clock; reading does not
+TEST(ExpiringLRUCacheTest, OverwriteRefreshesDeadline) {
+    TtlCache cache(4);
+    cache.set_default_ttl(10ms);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    advance(6ms);
+    cache.put(1, 11);
+    EXPECT_EQ(cache.get(2), 20);
+    advance(6ms);
+    EXPECT_EQ(cache.get(1), 11);
+    EXPECT_EQ(cache.get(2), -1);
+}
+
+// Overwriting with a TTL that lapses during the call leaves a valid cache:
+// the overwritten entry is not swept out from under the write
+TEST(ExpiringLRUCacheTest, OverwriteWithTtlLapsingMidCall) {
+    ExpiringLRUCache<int, int, TickingClock> cache(4);
+    for (int i = 0; i < 256; ++i) {
+        cache.put(i, i, 1h);
+        cache.put(i, i, 1ns);
+    }
+    for (int k = 1; k <= 8; ++k) cache.put(k, k, 1h);
+    size_t visited = 0;
+    cache.for_each([&](int k, int v) {
+        EXPECT_EQ(k, v);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 4u);
+    EXPECT_EQ(cache.size(), 4u);
+    for (int k = 5; k <= 8; ++k) EXPECT_EQ(cache.get(k), k);
+}
+
+// Rapid overwrites with a sub-tick TTL on the real clock
+TEST(ExpiringLRUCacheTest, OverwriteWithTinyTtl) {
+    ExpiringLRUCache<int, int> cache(4);
+    for (int i = 0; i < 100000; ++i) cache.put(0, i, 1ns);
+    EXPECT_LE(cache.size(), 1u);
+    cache.put(1, 1);
+    EXPECT_EQ(cache.get(1), 1);
+}
+
+// An expired entry found by a lookup is removed, freeing its capacity
+TEST(ExpiringLRUCacheTest, LazyRemovalOnLookup) {
+    TtlCache cache(2);
+    cache.put(1, 10, 1ms);
+    cache.put(2, 20);
+    advance(2ms);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.peek(1), nullptr);   // peek hides it but cannot remove it
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.get(1), -1);
+    EXPECT_EQ(cache.size(), 1u);
+    cache.put(3, 30);                    // fits without evicting 2
+    EXPECT_EQ(cache.get(2), 20);
+}
+
+// Writes sweep a few buckets each, so dead entries nobody reads go too
+TEST(ExpiringLRUCacheTest, IncrementalSweepOnWrites) {
+    TtlCache cache(1000);
+    for (int k = 0; k < 500; ++k) cache.put(k, k, 1ms);
+    advance(2ms);
+    for (int k = 1000; k < 2000; ++k) cache.put(k, k);
+    // Every bucket has been swept at least once, and no live entry was
+    // evicted to make room for the new ones.
+    EXPECT_EQ(cache.size(), 1000u);
+    for (int k = 1000; k < 2000; ++k) ASSERT_EQ(cache.peek(k) ? *cache.peek(k) : -1, k);
+}
+
+// purge_expired sweeps on demand and reports what it removed
+TEST(ExpiringLRUCacheTest, PurgeExpired) {
+    TtlCache cache(100);
+    for (int k = 0; k < 60; ++k) cache.put(k, k, k % 2 ? 1ms : 1h);
+    advance(1s);
+    EXPECT_EQ(cache.purge_expired(), 30u);
+    EXPECT_EQ(cache.size(), 30u);
+    EXPECT_EQ(cache.purge_expired(), 0u);
+}
+
+// Copies keep each entry's deadline and the default TTL
+TEST(ExpiringLRUCacheTest, CopyKeepsDeadlines) {
+    TtlCache cache(4);
+    cache.set_default_ttl(10ms);
+    cache.put(1, 10, 1ms);
+    cache.put(2, 20);
+    TtlCache copy(cache);
+    EXPECT_EQ(copy.default_ttl(), 10ms);
+    advance(2ms);
+    EXPECT_EQ(copy.get(1), -1);
+    EXPECT_EQ(copy.get(2), 20);
+    advance(10ms);
+    EXPECT_EQ(copy.get(2), -1);
+}
+
+// erase removes live entries and reports expired ones as absent
+TEST(ExpiringLRUCacheTest, Erase) {
+    TtlCache cache(4);
+    cache.put(1, 10, 1ms);
+    cache.put(2, 20);
+    EXPECT_TRUE(cache.erase(2));
+    EXPECT_FALSE(cache.erase(2));
+    advance(2ms);
+    EXPECT_FALSE(cache.erase(1));
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+// Non-positive TTLs are rejected
+TEST(ExpiringLRUCacheTest, RejectsNonPositiveTtl) {
+    TtlCache cache(4);
+    EXPECT_THROW(cache.set_default_ttl(0ms), std::invalid_argument);
+    EXPECT_THROW(cache.put(1, 1, -1ms), std::invalid_argument);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+// Weighted expiring caches give an expired entry's weight back
+TEST(ExpiringLRUCacheTest, ExpiryReleasesWeight) {
+    struct LengthWeigher {
+        size_t operator()(int, const std::string& v) const { return v.size(); }
+    };
+    LRUCache<int, std::string, std::hash<int>, std::equal_to<int>, std::allocator<std::pair<const int, std::string>>,
+             LruPolicy, LengthWeigher, ManualClock>
+        cache(100);
+    cache.put(1, std::string(60, 'a'), 1ms);
+    cache.put(2, std::string(30, 'b'));
+    advance(2ms);
+    EXPECT_EQ(cache.try_get(1), nullptr);
+    EXPECT_EQ(cache.weight(), 30u);
+}
+
+// CoarseClock is monotonic and keeps up with real time to within a few ticks
+TEST(CoarseClockTest, Advances) {
+    CoarseClock clock;
+    const int64_t start = clock.now();
+    std::this_thread::sleep_for(50ms);
+    const int64_t elapsed = clock.now() - start;
+    EXPECT_GE(elapsed, std::chrono::nanoseconds(30ms).count());
+    EXPECT_LT(elapsed, std::chrono::nanoseconds(5s).count());
+}
+
+// Erasing also works on caches without expiry
+TEST(ExpiringLRUCacheTest, EraseWithoutExpiry) {
+    IntLRUCache cache(2);
+    cache.put(1, 1);
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_EQ(cache.get(1), -1);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+// Nothing reads the clock while no entry has a finite deadline, and the
+// reads stop again once the last such entry is overwritten or evicted
+TEST(ExpiringLRUCacheTest, NoClockReadsWithoutDeadlines) {
+    ExpiringLRUCache<int, int, TickingClock> cache(4);
+    const int64_t before = TickingClock::reading;
+    for (int k = 0; k < 10; ++k) cache.put(k, k);
+    for (int k = 0; k < 10; ++k) cache.get(k);
+    cache.get_or_compute(20, [] { return 20; });
+    EXPECT_EQ(cache.purge_expired(), 0u);
+    EXPECT_EQ(TickingClock::reading, before);
+
+    cache.put(1, 1, 1h);
+    cache.put(2, 2, 1h);
+    cache.get(1);
+    EXPECT_GT(TickingClock::reading, before);
+    cache.put(1, 1);                                // overwritten without a TTL
+    for (int k = 100; k < 104; ++k) cache.put(k, k);   // evicts 2
+    const int64_t after = TickingClock::reading;
+    for (int k = 100; k < 104; ++k) cache.put(k, k);
+    for (int k = 100; k < 104; ++k) cache.get(k);
+    EXPECT_EQ(TickingClock::reading, after);
+}
@@ -0,0 +1,94 @@
+#include "LRUCache.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+// Weight of an entry is the length of its value.
+struct LengthWeigher {
+    size_t operator()(int, const std::string& v) const { return v.size(); }
+};
+
+using ByteCache = WeightedLRUCache<int, std::string, LengthWeigher>;
+}
+
+// Unweighted caches report their entry count as weight
+TEST(WeightedLRUCacheTest, UnitWeightIsEntryCount) {
+    IntLRUCache cache(3);
+    for (int k = 0; k < 5; ++k) cache.put(k, k);
+    EXPECT_EQ(cache.weight(), 3u);
+}
+
+// Inserting evicts least recently used entries until the new one fits
+TEST(WeightedLRUCacheTest, EvictsUntilFits) {
+    ByteCache cache(100);
+    for (int k = 0; k < 10; ++k) cache.put(k, std::string(10, 'x'));
+    EXPECT_EQ(cache.weight(), 100u);
+    EXPECT_EQ(cache.size(), 10u);
+    cache.get(0);                          // 0 becomes most recent
+    cache.put(100, std::string(35, 'y'));  // evicts 1, 2, 3, 4
+    EXPECT_EQ(cache.weight(), 95u);
+    EXPECT_EQ(cache.size(), 7u);
+    for (int k = 1; k <= 4; ++k) EXPECT_EQ(cache.peek(k), nullptr);
+    EXPECT_NE(cache.peek(0), nullptr);
+    EXPECT_NE(cache.peek(5), nullptr);
+}
+
+// An entry heavier than the whole budget is rejected and changes nothing
+TEST(WeightedLRUCacheTest, OverweightEntryRejected) {
+    ByteCache cache(50);
+    cache.put(1, std::string(20, 'a'));
+    EXPECT_THROW(cache.put(2, std::string(51, 'b')), std::invalid_argument);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.weight(), 20u);
+    EXPECT_EQ(cache.peek(2), nullptr);
+}
+
+// Growing a value on overwrite evicts other entries, never the one written
+TEST(WeightedLRUCacheTest, OverwriteReweighs) {
+    ByteCache cache(100);
+    for (int k = 0; k < 5; ++k) cache.put(k, std::string(20, 'x'));
+    cache.put(0, std::string(70, 'z'));    // 0 was the oldest; 1..3 go instead
+    ASSERT_NE(cache.peek(0), nullptr);
+    EXPECT_EQ(cache.peek(0)->size(), 70u);
+    EXPECT_EQ(cache.weight(), 90u);
+    EXPECT_EQ(cache.size(), 2u);
+    cache.put(0, std::string(5, 'z'));     // shrinking frees budget
+    EXPECT_EQ(cache.weight(), 25u);
+    EXPECT_THROW(cache.put(4, std::string(101, 'q')), std::invalid_argument);
+    EXPECT_EQ(cache.peek(4), nullptr);     // the overweight overwrite dropped it
+    EXPECT_EQ(cache.weight(), 5u);
+}
+
+// The budget holds under random traffic, also with W-TinyLFU
+TEST(WeightedLRUCacheTest, RandomTrafficStaysWithinBudget) {
+    WeightedLRUCache<int, std::string, LengthWeigher> lru(1000);
+    WeightedLRUCache<int, std::string, LengthWeigher, TinyLfuPolicy> tiny(1000);
+    std::mt19937 rng(8);
+    for (int i = 0; i < 20000; ++i) {
+        int k = static_cast<int>(rng() % 300);
+        std::string v(1 + rng() % 200, 'v');
+        if (!lru.try_get(k)) lru.put(k, v);
+        if (!tiny.try_get(k)) tiny.put(k, v);
+        ASSERT_LE(lru.weight(), 1000u);
+        ASSERT_LE(tiny.weight(), 1000u);
+    }
+    size_t sum = 0;
+    for (int k = 0; k < 300; ++k)
+        if (const std::string* v = tiny.peek(k)) sum += v->size();
+    EXPECT_EQ(sum, tiny.weight());
+}
+
+// Copies carry the weights along
+TEST(WeightedLRUCacheTest, CopyKeepsWeights) {
+    ByteCache a(100);
+    a.put(1, std::string(30, 'a'));
+    a.put(2, std::string(40, 'b'));
+    ByteCache b(a);
+    EXPECT_EQ(b.weight(), 70u);
+    b.put(3, std::string(40, 'c'));        // evicts 1 only
+    EXPECT_EQ(b.peek(1), nullptr);
+    EXPECT_EQ(b.weight(), 80u);
+}
@@ -0,0 +1,82 @@
+#include "MpmcRing.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Capacity rounds up to a power of two
+TEST(MpmcRingTest, CapacityRoundsUpToPowerOfTwo) {
+    MpmcRing<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+}
+
+// FIFO order for a single producer/consumer
+TEST(MpmcRingTest, PreservesFifoOrder) {
+    MpmcRing<int> ring(4);
+    for (int i = 0; i < 4; ++i) {
+        int v = i;
+        EXPECT_TRUE(ring.try_push(std::move(v)));
+    }
+    for (int i = 0; i < 4; ++i) {
+        int out = -1;
+        EXPECT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out, i);
+    }
+}
+
+// Push fails when full without consuming the argument; pop fails when empty
+TEST(MpmcRingTest, FullAndEmptyAreReported) {
+    MpmcRing<std::unique_ptr<int>> ring(2);
+    ring.try_push(std::make_unique<int>(1));
+    ring.try_push(std::make_unique<int>(2));
+    auto extra = std::make_unique<int>(3);
+    EXPECT_FALSE(ring.try_push(std::move(extra)));
+    ASSERT_NE(extra, nullptr);
+    EXPECT_EQ(*extra, 3);
+
+    std::unique_ptr<int> out;
+    EXPECT_TRUE(ring.try_pop(out));
+    EXPECT_TRUE(ring.try_pop(out));
+    EXPECT_FALSE(ring.try_pop(out));
+}
+
+// Remaining elements are destroyed with the ring
+TEST(MpmcRingTest, DestroysRemainingElements) {
+    auto tracker = std::make_shared<int>(0);
+    {
+        MpmcRing<std::shared_ptr<int>> ring(4);
+        auto copy = tracker;
+        ring.try_push(std::move(copy));
+        EXPECT_EQ(tracker.use_count(), 2);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+// Every pushed value is popped exactly once under concurrent producers and consumers
+TEST(MpmcRingTest, ConcurrentProducersAndConsumers) {
+    MpmcRing<int> ring(64);
+    const int producers = 4, consumers = 4, per_producer = 20000;
+    std::atomic<long long> sum{0};
+    std::atomic<int> popped{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&, p] {
+            for (int i = 1; i <= per_producer; ++i) {
+                int v = i;
+                while (!ring.try_push(std::move(v))) std::this_thread::yield();
+            }
+        });
+    for (int c = 0; c < consumers; ++c)
+        threads.emplace_back([&] {
+            int v;
+            while (popped.load() < producers * per_producer) {
+                if (ring.try_pop(v)) { sum += v; ++popped; }
+                else std::this_thread::yield();
+            }
+        });
+    for (auto& t : threads) t.join();
+    long long expected = static_cast<long long>(producers) * per_producer * (per_producer + 1) / 2;
+    EXPECT_EQ(sum.load(), expected);
+}
@@ -0,0 +1,117 @@
+#include "PoolCoroutine.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+CoroTask<std::thread::id> resume_on_pool(SimpleThreadPool& pool) {
+    co_await schedule(pool);
+    co_return std::this_thread::get_id();
+}
+
+CoroTask<int> add_on_pool(SimpleThreadPool& pool, int a, int b) {
+    co_await schedule(pool);
+    co_return a + b;
+}
+
+CoroTask<int> nested(SimpleThreadPool& pool) {
+    int x = co_await add_on_pool(pool, 1, 2);
+    int y = co_await add_on_pool(pool, x, 10);
+    co_return y;
+}
+
+CoroTask<void> failing(SimpleThreadPool& pool) {
+    co_await schedule(pool);
+    throw std::runtime_error("coroutine failed");
+}
+
+CoroTask<int> await_future(SimpleThreadPool& pool) {
+    auto f = spawn(pool, [] { return 21; });
+    int v = co_await f;
+    co_return v * 2;
+}
+
+CoroTask<void> wait_then_count(SimpleThreadPool& pool, PoolFuture<void> gate, std::atomic<int>& count) {
+    co_await schedule(pool);
+    co_await gate;
+    count.fetch_add(1);
+}
+
+CoroTask<void> fan_out(SimpleThreadPool& pool, PoolFuture<void> gate, std::atomic<int>& count, int n) {
+    std::vector<PoolFuture<void>> children;
+    for (int i = 0; i < n; ++i) children.push_back(start(pool, wait_then_count(pool, gate, count)));
+    co_await when_all(pool, children);
+}
+
+} // namespace
+
+// schedule() resumes the coroutine on a worker thread
+TEST(PoolCoroutineTest, ScheduleResumesOnWorker) {
+    SimpleThreadPool pool(1);
+    auto worker_id = sync_wait(resume_on_pool(pool));
+    EXPECT_NE(worker_id, std::this_thread::get_id());
+}
+
+// Awaiting a task yields its value
+TEST(PoolCoroutineTest, NestedTasksComposeValues) {
+    SimpleThreadPool pool(2);
+    EXPECT_EQ(sync_wait(nested(pool)), 13);
+}
+
+// Exceptions propagate to the awaiter
+TEST(PoolCoroutineTest, ExceptionPropagates) {
+    SimpleThreadPool pool(1);
+    EXPECT_THROW(sync_wait(failing(pool)), std::runtime_error);
+}
+
+// PoolFutures can be co_awaited
+TEST(PoolCoroutineTest, AwaitPoolFuture) {
+    SimpleThreadPool pool(2);
+    EXPECT_EQ(sync_wait(await_future(pool)), 42);
+}
+
+// Many more suspended coroutines than workers: none of them hold a thread
+TEST(PoolCoroutineTest, SuspendedCoroutinesDoNotBlockWorkers) {
+    SimpleThreadPool pool(2);
+    std::atomic<int> count{0};
+    auto gate_state = std::make_shared<PoolFutureState<void>>(pool);
+    PoolFuture<void> gate(gate_state);
+    std::thread opener([&] {
+        // Workers must still be free to run this while the coroutines wait on the gate.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(pool.enqueue([] { return 3; }).get(), 3);
+        gate_state->set_value();
+    });
+    sync_wait(fan_out(pool, gate, count, 100));
+    opener.join();
+    EXPECT_EQ(count.load(), 100);
+}
+
+// start() runs tasks concurrently and yields PoolFutures
+TEST(PoolCoroutineTest, StartReturnsPoolFuture) {
+    SimpleThreadPool pool(2);
+    auto f = start(pool, add_on_pool(pool, 20, 22));
+    EXPECT_EQ(f.get(), 42);
+    auto failed = start(pool, failing(pool));
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+// start() on a stopped pool fails the returned future instead of aborting
+TEST(PoolCoroutineTest, StartOnStoppedPoolFailsFuture) {
+    SimpleThreadPool pool(1);
+    pool.shutdown();
+    auto f = start(pool, add_on_pool(pool, 1, 2));
+    EXPECT_THROW(f.get(), std::runtime_error);
+}
+
+// enqueue keeps working alongside coroutine use
+TEST(PoolCoroutineTest, EnqueueStillWorks) {
+    SimpleThreadPool pool(2);
+    EXPECT_EQ(sync_wait(add_on_pool(pool, 2, 2)), 4);
+    EXPECT_EQ(pool.enqueue([] { return 5; }).get(), 5);
+}
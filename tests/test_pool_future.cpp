@@ -0,0 +1,164 @@
+#include "PoolFuture.h"
+#include "pool_test_util.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// spawn runs the callable on the pool
+TEST(PoolFutureTest, SpawnReturnsValue) {
+    SimpleThreadPool pool(2);
+    auto f = spawn(pool, [](int a, int b) { return a + b; }, 2, 3);
+    EXPECT_EQ(f.get(), 5);
+}
+
+// then chains value-transforming continuations
+TEST(PoolFutureTest, ThenChainsContinuations) {
+    SimpleThreadPool pool(2);
+    auto f = spawn(pool, [] { return 10; })
+                 .then([](const int& v) { return v * 2; })
+                 .then([](const int& v) { return std::to_string(v); });
+    EXPECT_EQ(f.get(), "20");
+}
+
+// Continuations attached after completion still run
+TEST(PoolFutureTest, ThenOnReadyFuture) {
+    SimpleThreadPool pool(1);
+    auto f = spawn(pool, [] { return 1; });
+    f.wait();
+    EXPECT_EQ(f.then([](const int& v) { return v + 1; }).get(), 2);
+}
+
+// void futures chain into void and non-void continuations
+TEST(PoolFutureTest, VoidFutures) {
+    SimpleThreadPool pool(2);
+    std::atomic<int> step{0};
+    auto f = spawn(pool, [&] { step = 1; })
+                 .then([&] { step = step * 10; })
+                 .then([&] { return step.load() + 1; });
+    EXPECT_EQ(f.get(), 11);
+}
+
+// Exceptions skip downstream continuations and surface at get()
+TEST(PoolFutureTest, ExceptionPropagatesThroughChain) {
+    SimpleThreadPool pool(2);
+    std::atomic<bool> ran{false};
+    auto f = spawn(pool, []() -> int { throw std::runtime_error("boom"); })
+                 .then([&](const int& v) { ran = true; return v; });
+    EXPECT_THROW(f.get(), std::runtime_error);
+    EXPECT_FALSE(ran.load());
+}
+
+// when_all collects values in input order
+TEST(PoolFutureTest, WhenAllCollectsValues) {
+    SimpleThreadPool pool(3);
+    std::vector<PoolFuture<int>> inputs;
+    for (int i = 0; i < 10; ++i) inputs.push_back(spawn(pool, [i] { return i * i; }));
+    auto all = when_all(pool, inputs);
+    std::vector<int> expected;
+    for (int i = 0; i < 10; ++i) expected.push_back(i * i);
+    EXPECT_EQ(all.get(), expected);
+}
+
+// when_all of an empty set is immediately ready; a failing input fails the join
+TEST(PoolFutureTest, WhenAllEmptyAndFailure) {
+    SimpleThreadPool pool(2);
+    EXPECT_TRUE(when_all(pool, std::vector<PoolFuture<void>>{}).is_ready());
+    std::vector<PoolFuture<int>> inputs{
+        spawn(pool, [] { return 1; }),
+        spawn(pool, []() -> int { throw std::logic_error("bad"); })};
+    EXPECT_THROW(when_all(pool, inputs).get(), std::logic_error);
+}
+
+// when_any reports the first input to finish
+TEST(PoolFutureTest, WhenAnyReturnsFirstReady) {
+    SimpleThreadPool pool(2);
+    std::promise<void> gate;
+    std::shared_future<void> hold = gate.get_future().share();
+    std::vector<PoolFuture<int>> inputs{
+        spawn(pool, [hold] { hold.wait(); return 0; }),
+        spawn(pool, [] { return 1; })};
+    EXPECT_EQ(when_any(pool, inputs).get(), 1u);
+    gate.set_value();
+    inputs[0].wait();
+}
+
+// Continuations on a single saturated worker never deadlock
+TEST(PoolFutureTest, DeepChainOnSingleWorker) {
+    SimpleThreadPool pool(1);
+    auto f = spawn(pool, [] { return 0; });
+    for (int i = 0; i < 1000; ++i) f = f.then([](const int& v) { return v + 1; });
+    EXPECT_EQ(f.get(), 1000);
+}
+
+// Completing a future from outside a full bounded pool runs its continuations
+// on the completing thread instead of dropping them
+TEST(PoolFutureTest, ContinuationsRunWhenQueueFull) {
+    ThreadPoolOptions opts;
+    opts.max_queued = 1;
+    opts.overflow = OverflowPolicy::Reject;
+    SimpleThreadPool pool(1, opts);
+    Blocker blocker(pool);
+    pool.post([] {});   // fills the queue
+    ASSERT_THROW(pool.post([] {}), QueueFullError);
+
+    auto source = std::make_shared<PoolFutureState<int>>(pool);
+    auto next = PoolFuture<int>(source).then([](const int& v) { return v + 1; });
+    source->set_value(41);
+    EXPECT_TRUE(next.is_ready());
+    EXPECT_EQ(next.get(), 42);
+    blocker.release();
+    pool.wait_idle();
+}
+
+// TaskGraph runs nodes after their dependencies
+TEST(TaskGraphTest, RespectsDependencies) {
+    SimpleThreadPool pool(4);
+    std::mutex m;
+    std::vector<int> order;
+    auto record = [&](int id) { return [&, id] { std::lock_guard<std::mutex> l(m); order.push_back(id); }; };
+    TaskGraph g;
+    auto a = g.add(record(0));
+    auto b = g.add(record(1), {a});
+    auto c = g.add(record(2), {a});
+    g.add(record(3), {b, c});
+    g.run(pool).get();
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_EQ(order.front(), 0);
+    EXPECT_EQ(order.back(), 3);
+}
+
+// A wide graph on one worker completes without blocking
+TEST(TaskGraphTest, WideGraphSingleWorker) {
+    SimpleThreadPool pool(1);
+    std::atomic<int> count{0};
+    TaskGraph g;
+    std::vector<TaskGraph::NodeId> layer;
+    for (int i = 0; i < 50; ++i) layer.push_back(g.add([&] { count++; }));
+    g.add([&] { count++; }, layer);
+    g.run(pool).get();
+    EXPECT_EQ(count.load(), 51);
+}
+
+// Errors stop unstarted nodes and surface on the run's future
+TEST(TaskGraphTest, ErrorSkipsDependents) {
+    SimpleThreadPool pool(2);
+    std::atomic<bool> ran{false};
+    TaskGraph g;
+    auto a = g.add([] { throw std::runtime_error("node failed"); });
+    g.add([&] { ran = true; }, {a});
+    EXPECT_THROW(g.run(pool).get(), std::runtime_error);
+    EXPECT_FALSE(ran.load());
+}
+
+// Dependencies must refer to existing nodes
+TEST(TaskGraphTest, RejectsUnknownDependency) {
+    TaskGraph g;
+    EXPECT_THROW(g.add([] {}, {3}), std::invalid_argument);
+}
@@ -0,0 +1,85 @@
+#include "ShardedLRUCache.h"
+#include <gtest/gtest.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+// A single shard behaves exactly like LRUCache
+TEST(ShardedLRUCacheTest, SingleShardIsPlainLRU) {
+    ShardedLRUCache cache(2, 1);
+    EXPECT_EQ(cache.shard_count(), 1u);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    EXPECT_EQ(cache.get(1), 1);
+    cache.put(3, 3);    // evicts 2
+    EXPECT_EQ(cache.get(2), -1);
+    EXPECT_EQ(cache.get(3), 3);
+    EXPECT_EQ(cache.get(1), 1);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+// Shard count is a power of two no larger than the request or the capacity
+TEST(ShardedLRUCacheTest, ShardCountRounding) {
+    EXPECT_EQ(ShardedLRUCache(100, 16).shard_count(), 16u);
+    EXPECT_EQ(ShardedLRUCache(100, 12).shard_count(), 8u);
+    EXPECT_EQ(ShardedLRUCache(5, 16).shard_count(), 4u);
+    EXPECT_EQ(ShardedLRUCache(1, 16).shard_count(), 1u);
+}
+
+// Zero capacity or zero shards is rejected
+TEST(ShardedLRUCacheTest, InvalidArguments) {
+    EXPECT_THROW(ShardedLRUCache(0), std::invalid_argument);
+    EXPECT_THROW(ShardedLRUCache(10, 0), std::invalid_argument);
+}
+
+// The split capacity adds up to exactly the requested total
+TEST(ShardedLRUCacheTest, TotalCapacityIsExact) {
+    ShardedLRUCache cache(100, 8);
+    for (int k = 0; k < 10000; ++k) cache.put(k, k);
+    EXPECT_EQ(cache.size(), 100u);
+}
+
+// Updating a key keeps one entry with the latest value
+TEST(ShardedLRUCacheTest, UpdateExistingKey) {
+    ShardedLRUCache cache(64, 8);
+    cache.put(7, 1);
+    cache.put(7, 2);
+    EXPECT_EQ(cache.get(7), 2);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+// Concurrent writers and readers on disjoint keys never lose an entry that fits
+TEST(ShardedLRUCacheTest, ConcurrentAccess) {
+    const int threads = 8, per_thread = 500;
+    ShardedLRUCache cache(threads * per_thread * 4, 16);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&cache, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                int key = t * per_thread + i;
+                cache.put(key, key * 2);
+                EXPECT_EQ(cache.get(key), key * 2);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    EXPECT_EQ(cache.size(), static_cast<size_t>(threads * per_thread));
+    for (int key = 0; key < threads * per_thread; ++key) ASSERT_EQ(cache.get(key), key * 2);
+}
+
+// The keys of one shard spread over the buckets of a shard-sized LRUCache
+// instead of sharing the bucket bits the shard was picked by
+TEST(ShardedLRUCacheTest, ShardKeysSpreadOverBuckets) {
+    const int keys = 1 << 16;
+    for (size_t shards : {16, 64}) {
+        ShardedLRUCache<int, int> sharded(keys, shards);
+        IntLRUCache shard_sized(keys / shards);
+        shard_sized.reserve(keys / shards);
+        std::set<size_t> used;
+        for (int k = 0; k < keys; ++k)
+            if (sharded.shard_of(k) == 0) used.insert(shard_sized.bucket(k));
+        // Hashing keys / shards keys at random into as many buckets fills ~63%.
+        EXPECT_GT(used.size(), shard_sized.bucket_count() / 2) << shards << " shards";
+    }
+}
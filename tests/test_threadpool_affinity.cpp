@@ -0,0 +1,69 @@
+#include "SimpleThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+// The sysfs list format expands ranges and single ids
+TEST(CpuTopologyTest, ParsesCpuLists) {
+    EXPECT_EQ(CpuTopology::parse_cpu_list("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(CpuTopology::parse_cpu_list("5"), (std::vector<int>{5}));
+    EXPECT_TRUE(CpuTopology::parse_cpu_list("\n").empty());
+}
+
+// Detection always yields at least one node with at least one CPU
+TEST(CpuTopologyTest, DetectsAtLeastOneNode) {
+    const CpuTopology& t = CpuTopology::instance();
+    ASSERT_GE(t.node_count(), 1u);
+    for (const auto& node : t.nodes) EXPECT_FALSE(node.empty());
+    int cpu = t.all_cpus().front();
+    EXPECT_LT(t.node_of(cpu), t.node_count());
+}
+
+#ifdef __linux__
+// RoundRobin pins each worker to exactly one allowed CPU
+TEST(ThreadPoolAffinityTest, RoundRobinPinsWorkers) {
+    ThreadPoolOptions opts;
+    opts.affinity = AffinityMode::RoundRobin;
+    SimpleThreadPool pool(2, opts);
+    const std::vector<int> all = CpuTopology::instance().all_cpus();
+    for (int i = 0; i < 8; ++i) {
+        int pinned = pool.enqueue([] {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            sched_getaffinity(0, sizeof(set), &set);
+            return CPU_COUNT(&set);
+        }).get();
+        EXPECT_EQ(pinned, 1);
+        EXPECT_NE(std::find(all.begin(), all.end(), current_cpu()), all.end());
+    }
+}
+#endif
+
+// CpuList affinity needs a non-empty list
+TEST(ThreadPoolAffinityTest, EmptyCpuListThrows) {
+    ThreadPoolOptions opts;
+    opts.affinity = AffinityMode::CpuList;
+    EXPECT_THROW(SimpleThreadPool(1, opts), std::invalid_argument);
+}
+
+// Node hints, including out-of-range ones, never strand a task
+TEST(ThreadPoolAffinityTest, NodeHintsRunEverywhere) {
+    for (auto mode : {SchedulingMode::SharedQueue, SchedulingMode::WorkStealing}) {
+        ThreadPoolOptions opts;
+        opts.numa_aware = true;
+        opts.mode = mode;
+        SimpleThreadPool pool(2, opts);
+        EXPECT_EQ(pool.node_count(), CpuTopology::instance().node_count());
+        std::atomic<int> count{0};
+        std::vector<std::future<void>> futures;
+        for (int node = -1; node < 5; ++node) {
+            SubmitOptions hint;
+            hint.node = node;
+            for (int i = 0; i < 20; ++i) futures.push_back(pool.enqueue_with(hint, [&] { count++; }));
+        }
+        for (auto& f : futures) f.get();
+        EXPECT_EQ(count.load(), 120);
+    }
+}
@@ -0,0 +1,105 @@
+#include "SimpleThreadPool.h"
+#include "TaskFunction.h"
+#include "allocation_counter.h"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Small callables are stored inline
+TEST(TaskFunctionTest, SmallCallableStaysInline) {
+    int hits = 0;
+    size_t count;
+    {
+        AllocationScope scope;
+        TaskFunction task([&hits] { ++hits; });
+        TaskFunction moved(std::move(task));
+        moved();
+        count = scope.count();
+    }
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(hits, 1);
+}
+
+// Callables larger than the inline buffer fall back to the heap and still run
+TEST(TaskFunctionTest, LargeCallableUsesHeap) {
+    std::array<char, 128> big{};
+    big[0] = 7;
+    int seen = 0;
+    size_t count;
+    {
+        AllocationScope scope;
+        TaskFunction task([big, &seen] { seen = big[0]; });
+        TaskFunction moved(std::move(task));
+        moved();
+        count = scope.count();
+    }
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(seen, 7);
+}
+
+// Move-only captures are supported and destroyed exactly once
+TEST(TaskFunctionTest, MoveOnlyCapture) {
+    auto owned = std::make_unique<int>(5);
+    int seen = 0;
+    TaskFunction task([p = std::move(owned), &seen] { seen = *p; });
+    TaskFunction other;
+    other = std::move(task);
+    EXPECT_FALSE(static_cast<bool>(task));
+    other();
+    EXPECT_EQ(seen, 5);
+}
+
+// After warm-up, enqueuing a small lambda performs no heap allocation on the caller
+TEST(ThreadPoolAllocationTest, EnqueueSmallLambdaIsAllocationFree) {
+    SimpleThreadPool pool(2);
+    const int batch = 256;
+    std::vector<std::future<int>> futures;
+    futures.reserve(2 * batch);
+
+    // Warm up the slab so its free lists hold enough shared states. Workers
+    // may still hold the last task they ran, so warm up with a spare batch.
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < batch; ++i) futures.push_back(pool.enqueue([i] { return i; }));
+    }
+    for (auto& f : futures) f.get();
+    futures.clear();
+
+    size_t count;
+    {
+        AllocationScope scope;
+        for (int i = 0; i < batch; ++i) futures.push_back(pool.enqueue([i] { return i + 1; }));
+        for (int i = 0; i < batch; ++i) EXPECT_EQ(futures[i].get(), i + 1);
+        futures.clear();
+        count = scope.count();
+    }
+    EXPECT_EQ(count, 0u);
+}
+
+// Bound arguments and void tasks go through the same allocation-free path
+TEST(ThreadPoolAllocationTest, EnqueueWithArgumentsIsAllocationFree) {
+    SimpleThreadPool pool(1);
+    std::atomic<int> sum{0};
+    auto add = [&sum](int a, int b) { sum += a + b; };
+    pool.enqueue(add, 0, 0).get();
+
+    size_t count;
+    {
+        AllocationScope scope;
+        for (int i = 0; i < 32; ++i) pool.enqueue(add, i, 1).get();
+        count = scope.count();
+    }
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(sum.load(), 32 * 31 / 2 + 32);
+}
+
+// Futures stay valid after the pool that created their shared state is gone
+TEST(ThreadPoolAllocationTest, FutureOutlivesPool) {
+    std::future<int> f;
+    {
+        SimpleThreadPool pool(1);
+        f = pool.enqueue([] { return 11; });
+    }
+    EXPECT_EQ(f.get(), 11);
+}
@@ -0,0 +1,120 @@
+#include "SimpleThreadPool.h"
+#include "pool_test_util.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+ThreadPoolOptions bounded(size_t capacity, OverflowPolicy policy) {
+    ThreadPoolOptions opts;
+    opts.max_queued = capacity;
+    opts.overflow = policy;
+    return opts;
+}
+
+}
+
+// try_enqueue and try_post fail once max_queued tasks are waiting
+TEST(ThreadPoolBackpressureTest, TryEnqueueFailsWhenFull) {
+    SimpleThreadPool pool(1, bounded(2, OverflowPolicy::Block));
+    Blocker blocker(pool);
+    auto a = pool.try_enqueue([] { return 1; });
+    auto b = pool.try_enqueue([] { return 2; });
+    ASSERT_TRUE(a && b);
+    EXPECT_FALSE(pool.try_enqueue([] { return 3; }));
+    EXPECT_FALSE(pool.try_post([] {}));
+    blocker.release();
+    EXPECT_EQ(a->get() + b->get(), 3);
+}
+
+// Reject throws QueueFullError from enqueue
+TEST(ThreadPoolBackpressureTest, RejectThrows) {
+    SimpleThreadPool pool(1, bounded(1, OverflowPolicy::Reject));
+    Blocker blocker(pool);
+    auto queued = pool.enqueue([] {});
+    EXPECT_THROW(pool.enqueue([] {}), QueueFullError);
+    blocker.release();
+    queued.get();
+    pool.wait_idle();
+}
+
+// Block parks the producer until a worker frees a slot
+TEST(ThreadPoolBackpressureTest, BlockWaitsForSpace) {
+    SimpleThreadPool pool(1, bounded(1, OverflowPolicy::Block));
+    Blocker blocker(pool);
+    pool.post([] {});
+    std::atomic<bool> submitted{false};
+    std::thread producer([&] {
+        pool.post([] {});
+        submitted = true;
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(submitted.load());
+    blocker.release();
+    producer.join();
+    EXPECT_TRUE(submitted.load());
+    pool.wait_idle();
+}
+
+// A blocked producer is released with an error when the pool shuts down
+TEST(ThreadPoolBackpressureTest, BlockedProducerWakesOnShutdown) {
+    SimpleThreadPool pool(1, bounded(1, OverflowPolicy::Block));
+    Blocker blocker(pool);
+    pool.post([] {});
+    std::atomic<bool> threw{false};
+    std::thread producer([&] {
+        try {
+            pool.post([] {});
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+    });
+    std::this_thread::sleep_for(20ms);
+    std::thread stopper([&] { pool.shutdown(ShutdownPolicy::Discard); });
+    producer.join();
+    blocker.release();
+    stopper.join();
+    EXPECT_TRUE(threw.load());
+}
+
+// CallerRuns executes the overflowing task on the submitting thread
+TEST(ThreadPoolBackpressureTest, CallerRunsOnSubmitter) {
+    SimpleThreadPool pool(1, bounded(1, OverflowPolicy::CallerRuns));
+    Blocker blocker(pool);
+    pool.post([] {});
+    auto f = pool.enqueue([] { return std::this_thread::get_id(); });
+    EXPECT_EQ(f.get(), std::this_thread::get_id());
+    blocker.release();
+    pool.wait_idle();
+}
+
+// DropOldest discards the oldest queued task to make room
+TEST(ThreadPoolBackpressureTest, DropOldestBreaksOldestPromise) {
+    SimpleThreadPool pool(1, bounded(2, OverflowPolicy::DropOldest));
+    Blocker blocker(pool);
+    auto first = pool.enqueue([] { return 1; });
+    auto second = pool.enqueue([] { return 2; });
+    auto third = pool.enqueue([] { return 3; });
+    blocker.release();
+    EXPECT_THROW(first.get(), std::future_error);
+    EXPECT_EQ(second.get(), 2);
+    EXPECT_EQ(third.get(), 3);
+}
+
+// Workers submitting into a full pool are never blocked
+TEST(ThreadPoolBackpressureTest, WorkersBypassCapacity) {
+    SimpleThreadPool pool(2, bounded(1, OverflowPolicy::Block));
+    std::atomic<int> count{0};
+    pool.enqueue([&] {
+        for (int i = 0; i < 50; ++i) pool.post([&] { count++; });
+    }).get();
+    pool.wait_idle();
+    EXPECT_EQ(count.load(), 50);
+}
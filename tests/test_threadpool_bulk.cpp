@@ -0,0 +1,132 @@
+#include "SimpleThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+// Task that flags `ran` when run. The copy taken when an instance with
+// `saw_run` set is submitted first waits (up to 10s) for an earlier task of
+// the batch to have run, and records in *saw_run whether one did.
+struct WaitsForEarlierTask {
+    explicit WaitsForEarlierTask(std::atomic<bool>* ran) : ran(ran) {}
+    WaitsForEarlierTask(const WaitsForEarlierTask& other) : ran(other.ran) {
+        if (!other.saw_run) return;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!ran->load() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+        *other.saw_run = ran->load();
+    }
+    void operator()() const { ran->store(true); }
+
+    std::atomic<bool>* ran;
+    bool* saw_run = nullptr;
+};
+}
+
+// Iterator-range bulk enqueue returns one future per callable, in order
+TEST(ThreadPoolBulkTest, EnqueueBulkRange) {
+    SimpleThreadPool pool(3);
+    std::vector<std::function<int()>> jobs;
+    for (int i = 0; i < 20; ++i) jobs.push_back([i] { return i * i; });
+    auto futures = pool.enqueue_bulk(jobs.begin(), jobs.end());
+    ASSERT_EQ(futures.size(), jobs.size());
+    for (int i = 0; i < 20; ++i) EXPECT_EQ(futures[i].get(), i * i);
+}
+
+// Count + callable form passes the index
+TEST(ThreadPoolBulkTest, EnqueueBulkCount) {
+    SimpleThreadPool pool(2);
+    auto futures = pool.enqueue_bulk(100, [](size_t i) { return static_cast<int>(i) + 1; });
+    int sum = 0;
+    for (auto& f : futures) sum += f.get();
+    EXPECT_EQ(sum, 5050);
+}
+
+// Bulk submission larger than the ring spills into the overflow queue
+TEST(ThreadPoolBulkTest, EnqueueBulkLargerThanRing) {
+    ThreadPoolOptions opts;
+    opts.ring_size = 8;
+    SimpleThreadPool pool(2, opts);
+    auto futures = pool.enqueue_bulk(1000, [](size_t i) { return i; });
+    for (size_t i = 0; i < futures.size(); ++i) EXPECT_EQ(futures[i].get(), i);
+}
+
+// Workers are woken a ring's worth of tasks at a time, so a large batch
+// starts running before all of it has been submitted
+TEST(ThreadPoolBulkTest, EnqueueBulkWakesWorkersAsItGoes) {
+    ThreadPoolOptions opts;
+    opts.ring_size = 8;
+    SimpleThreadPool pool(1, opts);
+    std::atomic<bool> ran{false};
+    bool saw_run = false;
+    std::vector<WaitsForEarlierTask> jobs(64, WaitsForEarlierTask(&ran));
+    jobs[40].saw_run = &saw_run;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));   // let the worker go to sleep
+    auto futures = pool.enqueue_bulk(jobs.begin(), jobs.end());
+    for (auto& f : futures) f.get();
+    EXPECT_TRUE(saw_run);
+}
+
+// Empty ranges are a no-op
+TEST(ThreadPoolBulkTest, EnqueueBulkEmpty) {
+    SimpleThreadPool pool(1);
+    EXPECT_TRUE(pool.enqueue_bulk(0, [](size_t) { return 0; }).empty());
+    pool.parallel_for(5, 5, 1, [](int) { FAIL(); });
+}
+
+// parallel_for visits every index exactly once
+TEST(ThreadPoolBulkTest, ParallelForVisitsEveryIndex) {
+    SimpleThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(10007);
+    pool.parallel_for(size_t(0), hits.size(), size_t(0), [&](size_t i) { hits[i].fetch_add(1); });
+    for (auto& h : hits) ASSERT_EQ(h.load(), 1);
+}
+
+// Explicit grain and a non-zero start
+TEST(ThreadPoolBulkTest, ParallelForWithGrain) {
+    SimpleThreadPool pool(3);
+    std::atomic<long> sum{0};
+    pool.parallel_for(10, 110, 7, [&](int i) { sum.fetch_add(i); });
+    EXPECT_EQ(sum.load(), (10 + 109) * 100 / 2);
+}
+
+// Nested parallel_for from inside a worker does not deadlock
+TEST(ThreadPoolBulkTest, ParallelForFromInsideWorker) {
+    SimpleThreadPool pool(2);
+    std::atomic<int> count{0};
+    auto outer = pool.enqueue([&] {
+        pool.parallel_for(0, 4, 1, [&](int) {
+            pool.parallel_for(0, 100, 10, [&](int) { count.fetch_add(1); });
+        });
+    });
+    outer.get();
+    EXPECT_EQ(count.load(), 400);
+}
+
+// The first exception thrown by the body is rethrown to the caller
+TEST(ThreadPoolBulkTest, ParallelForPropagatesException) {
+    SimpleThreadPool pool(2);
+    EXPECT_THROW(pool.parallel_for(0, 1000, 10, [](int i) {
+        if (i == 500) throw std::runtime_error("bad index");
+    }), std::runtime_error);
+    EXPECT_EQ(pool.enqueue([] { return 1; }).get(), 1);
+}
+
+// Work-stealing mode uses the local deque for bulk submissions from workers
+TEST(ThreadPoolBulkTest, BulkFromWorkerInWorkStealingMode) {
+    ThreadPoolOptions opts;
+    opts.mode = SchedulingMode::WorkStealing;
+    SimpleThreadPool pool(3, opts);
+    auto outer = pool.enqueue([&] {
+        auto inner = pool.enqueue_bulk(50, [](size_t i) { return i; });
+        size_t sum = 0;
+        for (auto& f : inner) sum += f.get();
+        return sum;
+    });
+    EXPECT_EQ(outer.get(), 49u * 50u / 2u);
+}
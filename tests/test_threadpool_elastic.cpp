@@ -0,0 +1,97 @@
+#include "SimpleThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Polls cond for up to two seconds.
+template<class Cond>
+bool eventually(Cond cond) {
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (cond()) return true;
+        std::this_thread::sleep_for(1ms);
+    }
+    return cond();
+}
+
+}
+
+// resize() grows and shrinks the running worker count
+TEST(ThreadPoolElasticTest, ResizeChangesSize) {
+    ThreadPoolOptions opts;
+    opts.max_threads = 4;
+    SimpleThreadPool pool(1, opts);
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.capacity(), 4u);
+    pool.resize(4);
+    EXPECT_EQ(pool.size(), 4u);
+    pool.resize(2);
+    EXPECT_TRUE(eventually([&] { return pool.size() == 2; }));
+    EXPECT_EQ(pool.enqueue([] { return 7; }).get(), 7);
+}
+
+// resize() rejects zero and sizes beyond capacity
+TEST(ThreadPoolElasticTest, ResizeValidatesSize) {
+    SimpleThreadPool pool(2);
+    EXPECT_THROW(pool.resize(0), std::invalid_argument);
+    EXPECT_THROW(pool.resize(3), std::invalid_argument);
+    pool.resize(1);
+    EXPECT_TRUE(eventually([&] { return pool.size() == 1; }));
+}
+
+// Every task still runs when workers retire with work queued behind them
+TEST(ThreadPoolElasticTest, ShrinkKeepsQueuedTasks) {
+    ThreadPoolOptions opts;
+    opts.mode = SchedulingMode::WorkStealing;
+    SimpleThreadPool pool(4, opts);
+    std::atomic<int> count{0};
+    auto outer = pool.enqueue([&] {
+        std::vector<std::future<void>> inner;
+        for (int i = 0; i < 200; ++i) inner.push_back(pool.enqueue([&] { count++; }));
+        return inner;
+    });
+    auto inner = outer.get();
+    pool.resize(1);
+    for (auto& f : inner) f.get();
+    EXPECT_EQ(count.load(), 200);
+}
+
+// A sustained backlog with no idle worker adds threads up to max_threads
+TEST(ThreadPoolElasticTest, GrowsUnderBacklog) {
+    ThreadPoolOptions opts;
+    opts.max_threads = 4;
+    opts.grow_after = std::chrono::microseconds(100);
+    SimpleThreadPool pool(1, opts);
+    std::atomic<bool> release{false};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 8; ++i)
+        futures.push_back(pool.enqueue([&] { while (!release) std::this_thread::sleep_for(1ms); }));
+    // Submissions keep checking the backlog as it ages.
+    EXPECT_TRUE(eventually([&] {
+        pool.post([] {});
+        return pool.size() == 4;
+    }));
+    release = true;
+    for (auto& f : futures) f.get();
+    EXPECT_LE(pool.size(), 4u);
+}
+
+// Workers idle for idle_timeout retire down to min_threads
+TEST(ThreadPoolElasticTest, IdleWorkersRetire) {
+    ThreadPoolOptions opts;
+    opts.max_threads = 4;
+    opts.min_threads = 1;
+    opts.idle_timeout = std::chrono::milliseconds(20);
+    SimpleThreadPool pool(1, opts);
+    pool.resize(4);
+    EXPECT_TRUE(eventually([&] { return pool.size() == 1; }));
+    EXPECT_EQ(pool.enqueue([] { return 1; }).get(), 1);
+}
@@ -0,0 +1,97 @@
+// Built with SIMPLE_THREAD_POOL_METRICS defined (see CMakeLists.txt).
+#include "SimpleThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Bucket bounds stay within the histogram's relative precision
+TEST(ThreadPoolMetricsTest, HistogramBucketsAreLogLinear) {
+    for (uint64_t v : {0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, ~0ull}) {
+        size_t b = HistogramSnapshot::bucket_of(v);
+        ASSERT_LT(b, HistogramSnapshot::bucket_count);
+        uint64_t lo = HistogramSnapshot::lower_bound(b);
+        EXPECT_LE(lo, v);
+        EXPECT_LE(v - lo, v / HistogramSnapshot::sub_count);
+    }
+}
+
+// Percentiles come from the recorded distribution
+TEST(ThreadPoolMetricsTest, HistogramPercentiles) {
+    HistogramSnapshot h;
+    for (uint64_t v = 1; v <= 100; ++v) {
+        h.counts[HistogramSnapshot::bucket_of(v * 1000)]++;
+        h.total++;
+        h.sum += v * 1000;
+    }
+    EXPECT_EQ(h.count(), 100u);
+    EXPECT_NEAR(static_cast<double>(h.percentile(50)), 50000.0, 50000.0 * 0.07);
+    EXPECT_NEAR(static_cast<double>(h.percentile(99)), 99000.0, 99000.0 * 0.07);
+    EXPECT_DOUBLE_EQ(h.mean(), 50500.0);
+}
+
+// Every executed task is counted with its run time; queue wait is sampled
+TEST(ThreadPoolMetricsTest, SnapshotCountsTasks) {
+    SimpleThreadPool pool(2);
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 50; ++i)
+        futures.push_back(pool.enqueue([] { std::this_thread::sleep_for(std::chrono::microseconds(200)); }));
+    for (auto& f : futures) f.get();
+    // The last future is ready just before its worker records the finish.
+    ThreadPoolMetrics::Snapshot s;
+    for (int i = 0; i < 1000 && (s = pool.metrics_snapshot()).tasks() < 50; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(s.tasks(), 50u);
+    EXPECT_EQ(s.run_time.count(), 50u);
+    // One submit in queue_wait_sample per thread, wherever this thread's count stands.
+    EXPECT_GE(s.queue_wait.count(), 50u / ThreadPoolMetrics::queue_wait_sample);
+    EXPECT_LE(s.queue_wait.count(), 50u / ThreadPoolMetrics::queue_wait_sample + 1);
+    EXPECT_GE(s.run_time.percentile(50), 150000u);
+    EXPECT_EQ(s.queue_depth, 0u);
+    EXPECT_GT(s.utilization(pool.size()), 0.0);
+}
+
+// A sampled bulk submit stamps all of its tasks with one clock reading
+TEST(ThreadPoolMetricsTest, BulkSubmitSharesQueueWaitSample) {
+    SimpleThreadPool pool(1);
+    for (unsigned call = 0; call < ThreadPoolMetrics::queue_wait_sample; ++call)
+        pool.post_bulk(std::vector<std::function<void()>>(64, [] {}));
+    pool.wait_idle();
+    EXPECT_EQ(pool.metrics_snapshot().queue_wait.count(), 64u);
+}
+
+// Steals are counted in work-stealing mode
+TEST(ThreadPoolMetricsTest, CountsSteals) {
+    ThreadPoolOptions opts;
+    opts.mode = SchedulingMode::WorkStealing;
+    SimpleThreadPool pool(2, opts);
+    pool.enqueue([&] {
+        std::vector<std::future<void>> inner;
+        for (int i = 0; i < 100; ++i)
+            inner.push_back(pool.enqueue([] { std::this_thread::sleep_for(std::chrono::microseconds(100)); }));
+        for (auto& f : inner) f.get();
+    }).get();
+    uint64_t steals = 0;
+    for (const auto& w : pool.metrics_snapshot().workers) steals += w.steals;
+    EXPECT_GT(steals, 0u);
+}
+
+// The trace holds one complete event per task, up to the buffer size
+TEST(ThreadPoolMetricsTest, WritesChromeTrace) {
+    ThreadPoolOptions opts;
+    opts.trace_events = 3;
+    SimpleThreadPool pool(1, opts);
+    for (int i = 0; i < 5; ++i) pool.enqueue([] {}).get();
+    std::ostringstream out;
+    pool.write_chrome_trace(out);
+    const std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    size_t events = 0;
+    for (size_t pos = 0; (pos = json.find("\"ph\":\"X\"", pos)) != std::string::npos; ++pos) ++events;
+    EXPECT_EQ(events, 3u);
+    EXPECT_NE(json.find("\"thread_name\""), std::string::npos);
+}
@@ -0,0 +1,72 @@
+#include "SimpleThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+template<class Pred>
+bool wait_for(Pred pred, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+}
+
+// Posted tasks run
+TEST(ThreadPoolPostTest, PostedTasksRun) {
+    SimpleThreadPool pool(2);
+    std::atomic<int> count{0};
+    for (int i = 0; i < 100; ++i) pool.post([&count] { count.fetch_add(1); });
+    EXPECT_TRUE(wait_for([&] { return count.load() == 100; }));
+}
+
+// post_bulk submits every element of a range
+TEST(ThreadPoolPostTest, PostBulkRunsAllCallables) {
+    SimpleThreadPool pool(3);
+    std::atomic<int> sum{0};
+    std::vector<std::function<void()>> jobs;
+    for (int i = 1; i <= 10; ++i) jobs.push_back([&sum, i] { sum.fetch_add(i); });
+    pool.post_bulk(jobs);
+    EXPECT_TRUE(wait_for([&] { return sum.load() == 55; }));
+}
+
+// Exceptions from posted tasks reach the error handler and don't kill the worker
+TEST(ThreadPoolPostTest, ErrorHandlerReceivesExceptions) {
+    SimpleThreadPool pool(1);
+    std::atomic<int> errors{0};
+    std::string message;
+    pool.set_error_handler([&](std::exception_ptr e) {
+        try { std::rethrow_exception(e); }
+        catch (const std::runtime_error& ex) { message = ex.what(); }
+        errors.fetch_add(1);
+    });
+    pool.post([] { throw std::runtime_error("posted failure"); });
+    EXPECT_TRUE(wait_for([&] { return errors.load() == 1; }));
+    EXPECT_EQ(message, "posted failure");
+    EXPECT_EQ(pool.enqueue([] { return 3; }).get(), 3);
+}
+
+// Without a handler exceptions are swallowed
+TEST(ThreadPoolPostTest, ExceptionsWithoutHandlerAreDiscarded) {
+    SimpleThreadPool pool(1);
+    pool.post([] { throw std::runtime_error("ignored"); });
+    EXPECT_EQ(pool.enqueue([] { return 4; }).get(), 4);
+}
+
+// Destructor runs pending posted tasks
+TEST(ThreadPoolPostTest, DestructorDrainsPostedTasks) {
+    std::atomic<int> count{0};
+    {
+        SimpleThreadPool pool(2);
+        for (int i = 0; i < 50; ++i) pool.post([&count] { count.fetch_add(1); });
+    }
+    EXPECT_EQ(count.load(), 50);
+}
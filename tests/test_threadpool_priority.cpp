@@ -0,0 +1,101 @@
+#include "SimpleThreadPool.h"
+#include "pool_test_util.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+SubmitOptions with_priority(TaskPriority p) {
+    SubmitOptions opts;
+    opts.priority = p;
+    return opts;
+}
+
+}
+
+// Queued tasks are served Interactive, then Normal, then Background
+TEST(ThreadPoolPriorityTest, HigherPriorityRunsFirst) {
+    ThreadPoolOptions opts;
+    opts.starvation_interval = 0;
+    SimpleThreadPool pool(1, opts);
+    std::mutex m;
+    std::vector<char> order;
+    auto record = [&](char c) { std::lock_guard<std::mutex> lock(m); order.push_back(c); };
+
+    Blocker blocker(pool);
+    auto b = pool.enqueue_with(with_priority(TaskPriority::Background), record, 'b');
+    auto n = pool.enqueue(record, 'n');
+    auto i = pool.enqueue_with(with_priority(TaskPriority::Interactive), record, 'i');
+    blocker.release();
+    b.get(); n.get(); i.get();
+    EXPECT_EQ(order, (std::vector<char>{'i', 'n', 'b'}));
+}
+
+// Background work still gets a turn while Interactive work is queued
+TEST(ThreadPoolPriorityTest, StarvationProtectionServesBackground) {
+    ThreadPoolOptions opts;
+    opts.starvation_interval = 4;
+    SimpleThreadPool pool(1, opts);
+    std::mutex m;
+    std::vector<char> order;
+    auto record = [&](char c) { std::lock_guard<std::mutex> lock(m); order.push_back(c); };
+
+    Blocker blocker(pool);
+    std::vector<std::future<void>> futures;
+    futures.push_back(pool.enqueue_with(with_priority(TaskPriority::Background), record, 'b'));
+    for (int k = 0; k < 20; ++k)
+        futures.push_back(pool.enqueue_with(with_priority(TaskPriority::Interactive), record, 'i'));
+    blocker.release();
+    for (auto& f : futures) f.get();
+
+    size_t pos = 0;
+    while (order[pos] != 'b') ++pos;
+    EXPECT_LT(pos, 4u);
+}
+
+// Tasks whose deadline passes while queued are dropped and break their promise
+TEST(ThreadPoolPriorityTest, ExpiredDeadlineDropsTask) {
+    SimpleThreadPool pool(1);
+    bool ran = false;
+    Blocker blocker(pool);
+    SubmitOptions opts;
+    opts.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+    auto f = pool.enqueue_with(opts, [&ran] { ran = true; return 1; });
+    bool posted_ran = false;
+    pool.post_with(opts, [&posted_ran] { posted_ran = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    blocker.release();
+    try {
+        f.get();
+        FAIL() << "expected broken promise";
+    } catch (const std::future_error& e) {
+        EXPECT_EQ(e.code(), std::make_error_code(std::future_errc::broken_promise));
+    }
+    pool.enqueue([] {}).get();
+    EXPECT_FALSE(ran);
+    EXPECT_FALSE(posted_ran);
+}
+
+// Tasks that start before their deadline run normally
+TEST(ThreadPoolPriorityTest, DeadlineInFutureRuns) {
+    SimpleThreadPool pool(2);
+    SubmitOptions opts;
+    opts.priority = TaskPriority::Interactive;
+    opts.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    EXPECT_EQ(pool.enqueue_with(opts, [](int x) { return x * 2; }, 21).get(), 42);
+}
+
+// Non-default priorities submitted from a work-stealing worker use the global lanes
+TEST(ThreadPoolPriorityTest, PriorityFromWorkStealingWorker) {
+    ThreadPoolOptions opts;
+    opts.mode = SchedulingMode::WorkStealing;
+    SimpleThreadPool pool(2, opts);
+    auto outer = pool.enqueue([&pool] {
+        return pool.enqueue_with(with_priority(TaskPriority::Background), [] { return 7; });
+    });
+    EXPECT_EQ(outer.get().get(), 7);
+}
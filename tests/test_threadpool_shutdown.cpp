@@ -0,0 +1,142 @@
+#include "SimpleThreadPool.h"
+#include "PoolFuture.h"
+#include "pool_test_util.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+bool is_broken(std::future<void>& f) {
+    try {
+        f.get();
+    } catch (const std::future_error& e) {
+        return e.code() == std::future_errc::broken_promise;
+    }
+    return false;
+}
+
+}
+
+// Drain runs every queued task, including follow-ups submitted while draining
+TEST(ThreadPoolShutdownTest, DrainRunsEverything) {
+    std::atomic<int> count{0};
+    {
+        SimpleThreadPool pool(2);
+        for (int i = 0; i < 50; ++i)
+            pool.post([&] {
+                count++;
+                pool.post([&] { count++; });
+            });
+        pool.shutdown(ShutdownPolicy::Drain);
+        EXPECT_EQ(count.load(), 100);
+        EXPECT_THROW(pool.post([] {}), std::runtime_error);
+    }
+    EXPECT_EQ(count.load(), 100);
+}
+
+// Discard drops queued tasks, breaks their promises and cancels stop_token()
+TEST(ThreadPoolShutdownTest, DiscardBreaksPromises) {
+    SimpleThreadPool pool(1);
+    CancellationToken stopping = pool.stop_token();
+    std::promise<void> gate;
+    std::promise<void> started;
+    auto running = pool.enqueue([&] {
+        started.set_value();
+        gate.get_future().wait();
+        return stopping.cancelled();
+    });
+    started.get_future().wait();
+    std::atomic<int> ran{0};
+    std::vector<std::future<void>> queued;
+    for (int i = 0; i < 10; ++i) queued.push_back(pool.enqueue([&] { ran++; }));
+
+    std::thread releaser([&] {
+        while (!stopping.cancelled()) std::this_thread::sleep_for(1ms);
+        gate.set_value();
+    });
+    pool.shutdown(ShutdownPolicy::Discard);
+    releaser.join();
+    EXPECT_TRUE(running.get());
+    for (auto& f : queued) EXPECT_TRUE(is_broken(f));
+    EXPECT_EQ(ran.load(), 0);
+}
+
+// DrainWithDeadline runs what it can before the deadline and drops the rest
+TEST(ThreadPoolShutdownTest, DrainWithDeadlineDropsBacklog) {
+    SimpleThreadPool pool(1);
+    std::atomic<int> ran{0};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 200; ++i)
+        futures.push_back(pool.enqueue([&] {
+            std::this_thread::sleep_for(5ms);
+            ran++;
+        }));
+    auto start = std::chrono::steady_clock::now();
+    pool.shutdown(ShutdownPolicy::DrainWithDeadline, 30ms);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+    int broken = 0;
+    for (auto& f : futures) broken += is_broken(f);
+    EXPECT_GT(ran.load(), 0);
+    EXPECT_GT(broken, 0);
+    EXPECT_EQ(ran.load() + broken, 200);
+}
+
+// PoolFutures whose tasks are discarded fail instead of hanging
+TEST(ThreadPoolShutdownTest, DiscardAbandonsPoolFutures) {
+    SimpleThreadPool pool(1);
+    Blocker blocker(pool);
+    auto a = spawn(pool, [] { return 1; });
+    auto b = a.then([](int v) { return v + 1; });
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(20ms);
+        blocker.release();
+    });
+    pool.shutdown(ShutdownPolicy::Discard);
+    releaser.join();
+    EXPECT_THROW(a.get(), std::future_error);
+    EXPECT_THROW(b.get(), std::future_error);
+}
+
+// Tasks whose token is cancelled before they start are skipped
+TEST(ThreadPoolShutdownTest, CancelledTasksAreSkipped) {
+    SimpleThreadPool pool(1);
+    CancellationSource source;
+    SubmitOptions opts;
+    opts.cancel = source.token();
+    std::atomic<int> ran{0};
+    Blocker blocker(pool);
+    auto skipped = pool.enqueue_with(opts, [&] { ran++; });
+    source.cancel();
+    blocker.release();
+    EXPECT_TRUE(is_broken(skipped));
+    EXPECT_EQ(ran.load(), 0);
+    EXPECT_THROW(opts.cancel.throw_if_cancelled(), OperationCancelled);
+    EXPECT_FALSE(CancellationToken().cancelled());
+}
+
+// wait_idle returns once all submitted work, including follow-ups, is done
+TEST(ThreadPoolShutdownTest, WaitIdle) {
+    SimpleThreadPool pool(2);
+    std::atomic<int> count{0};
+    for (int i = 0; i < 100; ++i)
+        pool.post([&] {
+            std::this_thread::sleep_for(100us);
+            pool.post([&] { count++; });
+            count++;
+        });
+    pool.wait_idle();
+    EXPECT_EQ(count.load(), 200);
+    EXPECT_TRUE(pool.wait_idle_for(1ms));
+
+    Blocker blocker(pool);
+    EXPECT_FALSE(pool.wait_idle_for(5ms));
+    blocker.release();
+    pool.wait_idle();
+}
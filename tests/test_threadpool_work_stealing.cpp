@@ -0,0 +1,117 @@
+#include "SimpleThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+ThreadPoolOptions stealing() {
+    ThreadPoolOptions opts;
+    opts.mode = SchedulingMode::WorkStealing;
+    return opts;
+}
+}
+
+// Default construction keeps the shared-queue design
+TEST(WorkStealingTest, DefaultModeIsSharedQueue) {
+    SimpleThreadPool pool(2);
+    EXPECT_EQ(pool.mode(), SchedulingMode::SharedQueue);
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+// External submissions go through the global queue and complete
+TEST(WorkStealingTest, ExternalTasksReturnValues) {
+    SimpleThreadPool pool(4, stealing());
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+        futures.push_back(pool.enqueue([i] { return i * 2; }));
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(futures[i].get(), i * 2);
+}
+
+// Tasks enqueued from a worker land in its local deque and are run LIFO by the owner
+TEST(WorkStealingTest, LocalTasksRunLifoOnSingleWorker) {
+    SimpleThreadPool pool(1, stealing());
+    std::vector<int> order;
+    std::mutex m;
+    auto outer = pool.enqueue([&] {
+        for (int i = 0; i < 3; ++i)
+            pool.enqueue([&, i] { std::lock_guard<std::mutex> lock(m); order.push_back(i); });
+    });
+    outer.get();
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (order.size() == 3) break;
+        }
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(order, (std::vector<int>{2, 1, 0}));
+}
+
+// Idle workers steal from a busy worker's deque
+TEST(WorkStealingTest, IdleWorkersStealLocalTasks) {
+    SimpleThreadPool pool(4, stealing());
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    std::vector<std::future<void>> children;
+    std::mutex children_mutex;
+    auto parent = pool.enqueue([&] {
+        for (int i = 0; i < 3; ++i) {
+            auto f = pool.enqueue([&] {
+                int now = ++running;
+                int prev = max_running.load();
+                while (now > prev && !max_running.compare_exchange_weak(prev, now)) {}
+                gate.wait();
+                --running;
+            });
+            std::lock_guard<std::mutex> lock(children_mutex);
+            children.push_back(std::move(f));
+        }
+    });
+    parent.get();
+
+    // The parent's worker is free again, but all three children can only run
+    // concurrently if the other workers stole them.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (max_running.load() < 3 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    release.set_value();
+    for (auto& f : children) f.get();
+    EXPECT_EQ(max_running.load(), 3);
+}
+
+// Recursive fan-out completes without deadlock
+TEST(WorkStealingTest, RecursiveFanOutCompletes) {
+    SimpleThreadPool pool(3, stealing());
+    std::atomic<int> count{0};
+    std::function<void(int)> spawn = [&](int depth) {
+        count.fetch_add(1);
+        if (depth == 0) return;
+        pool.enqueue(spawn, depth - 1);
+        pool.enqueue(spawn, depth - 1);
+    };
+    pool.enqueue(spawn, 10).get();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (count.load() < 2047 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+    EXPECT_EQ(count.load(), 2047);
+}
+
+// Destructor drains local deques as well as the global queue
+TEST(WorkStealingTest, DestructorRunsPendingLocalTasks) {
+    std::atomic<int> count{0};
+    {
+        SimpleThreadPool pool(2, stealing());
+        pool.enqueue([&] {
+            for (int i = 0; i < 50; ++i)
+                pool.enqueue([&] { count.fetch_add(1); });
+        }).get();
+    }
+    EXPECT_EQ(count.load(), 50);
+}
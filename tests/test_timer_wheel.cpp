@@ -0,0 +1,132 @@
+#include "SimpleThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// Timers fire on their tick in order, across every level of the wheel
+TEST(TimerWheelTest, FiresInTickOrder) {
+    TimerWheel<int> wheel;
+    const uint64_t ticks[] = {1, 255, 256, 257, 65535, 65536, 70000, 16777216, (1ull << 32) + 5};
+    for (uint64_t t : ticks) wheel.schedule(t, static_cast<int>(t & 0xffff));
+    std::vector<uint64_t> fired_at;
+    wheel.advance((1ull << 32) + 10, [&](TimerWheel<int>::Id, int&) {
+        fired_at.push_back(wheel.now());
+        return uint64_t(0);
+    });
+    EXPECT_EQ(fired_at, std::vector<uint64_t>(std::begin(ticks), std::end(ticks)));
+    EXPECT_TRUE(wheel.empty());
+}
+
+// Randomly scheduled timers each fire exactly at their tick
+TEST(TimerWheelTest, RandomTimersFireOnTime) {
+    TimerWheel<uint64_t> wheel(1000);
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 5000; ++i) {
+        uint64_t t = 1000 + rng() % 200000;
+        wheel.schedule(t, t);
+    }
+    size_t fired = 0;
+    auto check = [&](TimerWheel<uint64_t>::Id, uint64_t& expected) {
+        EXPECT_EQ(wheel.now(), expected);
+        ++fired;
+        return uint64_t(0);
+    };
+    for (uint64_t now = 1000; now < 201000; now += 1 + rng() % 700) wheel.advance(now, check);
+    wheel.advance(201000, check);
+    EXPECT_EQ(fired, 5000u);
+}
+
+// Cancelled timers never fire and stale ids are rejected
+TEST(TimerWheelTest, CancelIsFinal) {
+    TimerWheel<int> wheel;
+    auto a = wheel.schedule(10, 1);
+    auto b = wheel.schedule(300, 2);
+    EXPECT_TRUE(wheel.cancel(b));
+    EXPECT_FALSE(wheel.cancel(b));
+    int fired = 0;
+    wheel.advance(1000, [&](TimerWheel<int>::Id, int& v) { fired += v; return uint64_t(0); });
+    EXPECT_EQ(fired, 1);
+    EXPECT_FALSE(wheel.cancel(a));
+    auto c = wheel.schedule(2000, 3);   // reuses a node
+    EXPECT_FALSE(wheel.cancel(a));
+    EXPECT_TRUE(wheel.cancel(c));
+}
+
+// Returning a tick re-arms the timer under the same id
+TEST(TimerWheelTest, RearmKeepsId) {
+    TimerWheel<int> wheel;
+    auto id = wheel.schedule(5, 0);
+    int runs = 0;
+    wheel.advance(50, [&](TimerWheel<int>::Id fired, int&) {
+        EXPECT_EQ(fired, id);
+        ++runs;
+        return wheel.now() + 10;
+    });
+    EXPECT_EQ(runs, 5);
+    EXPECT_TRUE(wheel.cancel(id));
+}
+
+// schedule_after runs the callback on the pool no earlier than requested.
+// How much later depends on the machine's load, so only a hang fails.
+TEST(ThreadPoolTimerTest, ScheduleAfter) {
+    std::promise<std::chrono::steady_clock::time_point> fired;
+    auto when = fired.get_future();
+    SimpleThreadPool pool(2);
+    auto start = std::chrono::steady_clock::now();
+    pool.schedule_after(20ms, [&] { fired.set_value(std::chrono::steady_clock::now()); });
+    ASSERT_EQ(when.wait_for(30s), std::future_status::ready);
+    EXPECT_GE(when.get() - start, 20ms);
+}
+
+// Timers are serviced while every worker is busy with other tasks
+TEST(ThreadPoolTimerTest, FiresWhileWorkersBusy) {
+    SimpleThreadPool pool(1);
+    std::atomic<bool> fired{false};
+    std::atomic<bool> stop{false};
+    pool.schedule_after(5ms, [&] { fired = true; });
+    std::function<void()> chatter = [&] {
+        if (!stop) pool.post(chatter);
+    };
+    pool.post(chatter);
+    auto deadline = std::chrono::steady_clock::now() + 30s;
+    while (!fired && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(1ms);
+    stop = true;
+    pool.wait_idle();
+    EXPECT_TRUE(fired.load());
+}
+
+// schedule_every repeats until cancelled; cancelled one-shots never run
+TEST(ThreadPoolTimerTest, PeriodicAndCancel) {
+    SimpleThreadPool pool(2);
+    std::atomic<int> ticks{0};
+    std::atomic<bool> cancelled_ran{false};
+    auto id = pool.schedule_every(2ms, [&] { ticks++; });
+    auto never = pool.schedule_after(30ms, [&] { cancelled_ran = true; });
+    EXPECT_TRUE(pool.cancel_timer(never));
+    auto deadline = std::chrono::steady_clock::now() + 30s;   // only a hang should fail
+    while (ticks.load() < 5 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(1ms);
+    EXPECT_GE(ticks.load(), 5);
+    EXPECT_TRUE(pool.cancel_timer(id));
+    pool.wait_idle();
+    int after_cancel = ticks.load();
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(ticks.load(), after_cancel);
+    EXPECT_FALSE(cancelled_ran.load());
+}
+
+// Pending timers are dropped at shutdown and scheduling afterwards throws
+TEST(ThreadPoolTimerTest, ShutdownDropsTimers) {
+    SimpleThreadPool pool(1);
+    std::atomic<bool> ran{false};
+    pool.schedule_after(1h, [&] { ran = true; });
+    pool.shutdown();
+    EXPECT_FALSE(ran.load());
+    EXPECT_THROW(pool.schedule_after(1ms, [] {}), std::runtime_error);
+}